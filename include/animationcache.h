@@ -0,0 +1,100 @@
+#ifndef ANIMATIONCACHE_H
+#define ANIMATIONCACHE_H
+
+#include <QCache>
+#include <QFutureWatcher>
+#include <QImage>
+#include <QObject>
+#include <QPixmap>
+#include <QSet>
+#include <QSize>
+#include <QVector>
+
+/**
+ * @brief Decoded frames of one animation and their delays.
+ */
+struct Animation
+{
+    QVector<QPixmap> frames;
+
+    /**
+     * @brief Delay of each frame in milliseconds.
+     */
+    QVector<int> delays;
+};
+
+/**
+ * @brief Bounded cache of animations decoded on worker threads.
+ *
+ * @details Frames are decoded with QImageReader in the thread pool and converted to pixmaps on the GUI thread.
+ * The cache cost is the size of the frames in kilobytes, so memory stays capped however many animations are viewed.
+ */
+class AnimationCache : public QObject
+{
+    Q_OBJECT
+
+  public:
+    AnimationCache(QSize frame_size, int max_cost_kb, QObject *parent = nullptr);
+
+    /**
+     * @brief Get the decoded animation or nullptr if it isn't decoded yet.
+     *
+     * @details The pointer is valid until the next insertion into the cache.
+     */
+    const Animation *find(const QString &path) const;
+
+    /**
+     * @brief Start decoding the animation if it isn't cached or already decoding.
+     *
+     * @see #animationReady
+     */
+    void request(const QString &path);
+
+  signals:
+    /**
+     * @brief Emitted on the GUI thread when the animation has been decoded and cached.
+     */
+    void animationReady(QString path);
+
+  private:
+    /**
+     * @brief Frames produced by the worker thread.
+     */
+    struct DecodedFrames
+    {
+        QString path;
+        QVector<QImage> images;
+        QVector<int> delays;
+    };
+
+    /**
+     * @brief Decode up to max_frames frames of the file scaled to the frame size. Runs on a worker thread.
+     */
+    static DecodedFrames decode(const QString &path, QSize frame_size, int max_frames);
+
+    /**
+     * @brief Move finished frames into the cache.
+     */
+    void decodeFinished(QFutureWatcher<DecodedFrames> *watcher);
+
+    QCache<QString, Animation> m_cache;
+
+    /**
+     * @brief Paths that are decoding right now.
+     */
+    QSet<QString> m_pending;
+
+    QSize m_frame_size;
+
+    /**
+     * @brief Number of frames that fit into the whole cache, at most #MAX_FRAMES.
+     */
+    int m_max_frames;
+
+    /**
+     * @brief Maximum number of decoded frames per animation.
+     */
+    static const int MAX_FRAMES = 600;
+};
+
+#endif // ANIMATIONCACHE_H
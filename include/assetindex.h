@@ -0,0 +1,105 @@
+#ifndef ASSETINDEX_H
+#define ASSETINDEX_H
+
+#include <QDataStream>
+#include <QHash>
+#include <QString>
+
+/**
+ * @brief Size and modification time of an indexed file or folder.
+ */
+struct AssetInfo
+{
+    qint64 size = -1;
+
+    /**
+     * @brief Modification time in milliseconds since epoch.
+     */
+    qint64 modified = 0;
+
+    bool is_dir = false;
+
+    bool isValid() const { return size >= 0; }
+};
+
+/**
+ * @brief Index of the files in the base folder.
+ *
+ * @details Built once per base folder on a worker thread and shared by all workspaces.
+ * Paths are relative to the base folder, e.g. "sounds/music/song.opus".
+ */
+class AssetIndex
+{
+  public:
+    /**
+     * @brief Index background/, characters/ and sounds/ of the base folder.
+     *
+     * @details Blocking, call it from a worker thread.
+     */
+    static AssetIndex scan(const QString &base_folder);
+
+    /**
+     * @brief Check if the file or folder exists in the base folder.
+     */
+    bool contains(const QString &path) const;
+
+    /**
+     * @brief Get information about the file or folder, invalid if it isn't indexed.
+     */
+    AssetInfo info(const QString &path) const;
+
+    /**
+     * @brief Get the size of the files of each folder in the folder, e.g. of each background.
+     *
+     * @details Folders themselves are indexed with size 0, so their sizes are summed in one pass over the index.
+     *
+     * @param folder Folder ending with a slash, e.g. "background/".
+     */
+    QHash<QString, qint64> folderSizes(const QString &folder) const;
+
+    /**
+     * @brief Get all indexed files and folders.
+     */
+    const QHash<QString, AssetInfo> &assets() const;
+
+    QString baseFolder() const;
+
+    int count() const;
+
+    bool isEmpty() const;
+
+    /**
+     * @brief Check that no file was added or removed since the scan.
+     *
+     * @details Compares modification times of the indexed folders, that is much faster than the scan.
+     * Files changed in place aren't detected.
+     */
+    bool isCurrent() const;
+
+    /**
+     * @brief Write the index for the session snapshot.
+     */
+    void write(QDataStream &out) const;
+
+    /**
+     * @brief Read the index written by #write.
+     */
+    bool read(QDataStream &in);
+
+  private:
+    /**
+     * @brief Get the modification time of the folder, 0 if it doesn't exist.
+     */
+    static qint64 folderModified(const QString &path);
+
+    QString m_base_folder;
+
+    QHash<QString, AssetInfo> m_assets;
+
+    /**
+     * @brief Modification times of background/, characters/ and sounds/.
+     */
+    QHash<QString, qint64> m_roots;
+};
+
+#endif // ASSETINDEX_H
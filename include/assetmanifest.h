@@ -0,0 +1,72 @@
+#ifndef ASSETMANIFEST_H
+#define ASSETMANIFEST_H
+
+#include "include/assetindex.h"
+#include "include/configfile.h"
+#include "include/hashcache.h"
+#include <QFuture>
+#include <QMap>
+#include <QStringList>
+
+/**
+ * @brief One file of the manifest.
+ */
+struct ManifestEntry
+{
+    /**
+     * @brief Path relative to the base folder.
+     */
+    QString path;
+
+    /**
+     * @brief Size in bytes, -1 if the file doesn't exist.
+     */
+    qint64 size = -1;
+
+    /**
+     * @brief SHA-256 of the content.
+     */
+    QByteArray hash;
+};
+
+/**
+ * @brief Manifest of the assets referenced by the configs, with their sizes and content hashes.
+ *
+ * @details The manifest is a text file with a "hash size path" line per asset, sorted by path.
+ */
+class AssetManifest
+{
+  public:
+    /**
+     * @brief Get files referenced by the configs: folders of backgrounds and characters, and songs.
+     *
+     * @param configs Configs by their names, e.g. "/music.json".
+     */
+    static QStringList referencedAssets(const QMap<QString, QVector<ConfigEntry>> &configs, const AssetIndex &index);
+
+    /**
+     * @brief Hash the files of the base folder in the thread pool.
+     *
+     * @details Unchanged files are taken from the cache.
+     */
+    static QFuture<ManifestEntry> hash(const QString &base_folder, const QStringList &paths, HashCache *cache);
+
+    /**
+     * @brief Write the manifest.
+     */
+    static bool write(const QString &filename, QVector<ManifestEntry> entries);
+
+    /**
+     * @brief Read the manifest.
+     */
+    static QVector<ManifestEntry> read(const QString &filename, bool *ok = nullptr);
+
+    /**
+     * @brief Compare hashed files with the manifest.
+     *
+     * @return Descriptions of missing and mismatched files.
+     */
+    static QStringList verify(const QVector<ManifestEntry> &expected, const QVector<ManifestEntry> &actual);
+};
+
+#endif // ASSETMANIFEST_H
@@ -0,0 +1,60 @@
+#ifndef BULKRENAME_H
+#define BULKRENAME_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * @brief Find and replace rule of the bulk rename.
+ */
+struct RenameRule
+{
+    enum Mode {
+        Text,
+        Regex
+    };
+
+    Mode mode = Text;
+
+    QString find;
+
+    /**
+     * @brief Replacement text, in the regex mode "\1" and so on insert captured groups.
+     */
+    QString replace;
+
+    Qt::CaseSensitivity case_sensitivity = Qt::CaseSensitive;
+};
+
+/**
+ * @brief New name of one item.
+ */
+struct RenameChange
+{
+    int id;
+    QString old_name;
+    QString new_name;
+};
+
+/**
+ * @brief Applying of rename rules to many names at once.
+ */
+class BulkRename
+{
+  public:
+    /**
+     * @brief Get new names of all names by the rule.
+     *
+     * @details Names are renamed in parallel chunks. If the regular expression is invalid, the names are returned unchanged and the error is set.
+     */
+    static QVector<QString> apply(const QStringList &names, const RenameRule &rule, QString *error = nullptr);
+
+  private:
+    /**
+     * @brief Number of names renamed by one task.
+     */
+    static const int CHUNK_SIZE = 4096;
+};
+
+#endif // BULKRENAME_H
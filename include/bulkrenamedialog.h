@@ -0,0 +1,83 @@
+#ifndef BULKRENAMEDIALOG_H
+#define BULKRENAMEDIALOG_H
+
+#include "include/assetindex.h"
+#include "include/bulkrename.h"
+#include "include/renamepreviewmodel.h"
+#include <QCheckBox>
+#include <QComboBox>
+#include <QDialog>
+#include <QDialogButtonBox>
+#include <QLabel>
+#include <QLineEdit>
+#include <QSet>
+#include <QTableView>
+
+/**
+ * @brief Dialog for renaming many items by one find and replace rule with the preview of new names.
+ *
+ * @details New names are checked against the asset index, each other and the rest of the config. A name conflicts if
+ * different old names get it or another item already has it. Empty names and conflicts block the rename, except conflicts
+ * of songs in music configs, which may list a song several times. Those and names without an asset are only marked.
+ */
+class BulkRenameDialog : public QDialog
+{
+    Q_OBJECT
+
+  public:
+    /**
+     * @param others Names of the config's items that aren't renamed.
+     *
+     * @param index Indexed base folder, empty if the base folder isn't opened.
+     *
+     * @param folder Folder of assets relative to the base folder, like "sounds/music/".
+     *
+     * @param categories Whether names without an extension are categories that have no asset.
+     */
+    BulkRenameDialog(const QVector<int> &ids, const QStringList &names, const QSet<QString> &others, const AssetIndex *index, const QString &folder, bool categories, QWidget *parent = nullptr);
+
+    /**
+     * @brief Get items whose names are changed by the current rule.
+     */
+    QVector<RenameChange> changes() const;
+
+  private:
+    /**
+     * @brief Rename all names by the current rule and check them.
+     */
+    void updatePreview();
+
+    QVector<int> m_ids;
+
+    QStringList m_names;
+
+    QSet<QString> m_others;
+
+    QVector<QString> m_new_names;
+
+    QVector<RenamePreviewModel::Status> m_statuses;
+
+    const AssetIndex *m_index;
+
+    QString m_folder;
+
+    bool m_categories;
+
+    QLineEdit *m_find;
+
+    QLineEdit *m_replace;
+
+    QComboBox *m_mode;
+
+    QCheckBox *m_case;
+
+    QTableView *m_preview;
+
+    RenamePreviewModel *m_model;
+
+    QLabel *m_status;
+
+    QDialogButtonBox *m_buttons;
+};
+
+#endif // BULKRENAMEDIALOG_H
@@ -0,0 +1,87 @@
+#ifndef CONFIGDIFF_H
+#define CONFIGDIFF_H
+
+#include "include/configfile.h"
+#include <QVector>
+
+/**
+ * @brief One change between two versions of a config.
+ */
+struct DiffHunk
+{
+    enum Type {
+        Insert,
+        Delete,
+        Move,
+        Rename,
+        Length
+    };
+
+    Type type;
+
+    /**
+     * @brief Entry on the old side. Empty for Insert.
+     */
+    ConfigEntry old_entry;
+
+    /**
+     * @brief Entry on the new side. Empty for Delete.
+     */
+    ConfigEntry new_entry;
+
+    /**
+     * @brief Position of the entry on the old side, -1 for Insert.
+     */
+    int old_index;
+
+    /**
+     * @brief Position of the entry on the new side, -1 for Delete.
+     */
+    int new_index;
+
+    /**
+     * @brief Nearest entry before it on the old side that exists on both sides, as its position on the new side.
+     * -1 if there is none.
+     */
+    int old_anchor;
+
+    /**
+     * @brief Nearest entry before it on the new side that exists on both sides, as its position on the old side.
+     * -1 if there is none.
+     */
+    int new_anchor;
+};
+
+/**
+ * @brief Entry-by-entry comparison of two versions of a config.
+ *
+ * @details Entries are matched by hashed keys with Heckel's algorithm, which runs in linear time and finds moved entries.
+ * Hunks reference entries by their positions instead of names, so any subset of them can be applied to either side
+ * and a song listed several times is changed where it was changed.
+ */
+class ConfigDiff
+{
+  public:
+    /**
+     * @brief Get changes that turn the old config into the new one.
+     */
+    static QVector<DiffHunk> compare(const QVector<ConfigEntry> &old_entries, const QVector<ConfigEntry> &new_entries);
+
+    /**
+     * @brief Apply the hunks to the old side they were compared from.
+     */
+    static QVector<ConfigEntry> apply(QVector<ConfigEntry> entries, const QVector<DiffHunk> &hunks);
+
+    /**
+     * @brief Apply the hunks backwards to the new side they were compared from.
+     */
+    static QVector<ConfigEntry> revert(const QVector<ConfigEntry> &entries, const QVector<DiffHunk> &hunks);
+
+  private:
+    /**
+     * @brief Get the hunk turning the new side into the old one.
+     */
+    static DiffHunk inverted(const DiffHunk &hunk);
+};
+
+#endif // CONFIGDIFF_H
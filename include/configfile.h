@@ -0,0 +1,111 @@
+#ifndef CONFIGFILE_H
+#define CONFIGFILE_H
+
+#include <QFuture>
+#include <QMap>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief One line of a config.
+ */
+struct ConfigEntry
+{
+    QString name;
+
+    /**
+     * @brief Song length for music.json, "category" for its categories and empty for other configs.
+     */
+    QString length;
+
+    bool operator==(const ConfigEntry &other) const { return name == other.name && length == other.length; }
+};
+
+/**
+ * @brief Outcome of writing one config.
+ */
+struct ConfigSaveResult
+{
+    QString key;
+
+    bool ok = false;
+
+    /**
+     * @brief Reason of the failure.
+     */
+    QString error;
+};
+
+/**
+ * @brief Outcome of reading one config.
+ */
+struct ConfigLoadResult
+{
+    QString key;
+
+    bool ok = false;
+
+    QVector<ConfigEntry> entries;
+};
+
+/**
+ * @brief Reading and writing of backgrounds.txt, characters.txt, music.txt and music.json.
+ *
+ * @see ConfigFormat
+ */
+class ConfigFile
+{
+  public:
+    /**
+     * @brief Read the config from the config folder.
+     *
+     * @param key Name of the config, e.g. "/music.json".
+     *
+     * @param ok Set to false if the config can't be read.
+     */
+    static QVector<ConfigEntry> read(const QString &folder, const QString &key, bool *ok = nullptr);
+
+    /**
+     * @brief Read configs concurrently on the thread pool.
+     *
+     * @details Loading takes about as long as the largest config. Canceling the future drops the configs that haven't started yet.
+     *
+     * @param keys Names of configs, the future has one result per config.
+     */
+    static QFuture<ConfigLoadResult> readAll(const QString &folder, const QStringList &keys);
+
+    /**
+     * @brief Write the config into the config folder.
+     *
+     * @details The config is replaced only when it's completely written, so a failed save keeps the old one.
+     *
+     * @param error Set to the reason if the config can't be written.
+     *
+     * @return False if the config can't be written.
+     */
+    static bool write(const QString &folder, const QString &key, const QVector<ConfigEntry> &entries, QString *error = nullptr);
+
+    /**
+     * @brief Write configs concurrently on the thread pool.
+     *
+     * @param configs Items of configs by config name, the future has one result per config.
+     */
+    static QFuture<ConfigSaveResult> writeAll(const QString &folder, const QMap<QString, QVector<ConfigEntry>> &configs);
+
+    /**
+     * @brief Check if the item is a category, i.e. it has neither an extension nor a folder.
+     */
+    static bool isCategory(const QString &name);
+
+    /**
+     * @brief Check if the config has song lengths, i.e. it's music.json.
+     */
+    static bool hasLengths(const QString &key);
+
+    /**
+     * @brief Check if the config can have categories, i.e. it's music.txt or music.json.
+     */
+    static bool hasCategories(const QString &key);
+};
+
+#endif // CONFIGFILE_H
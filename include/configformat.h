@@ -0,0 +1,108 @@
+#ifndef CONFIGFORMAT_H
+#define CONFIGFORMAT_H
+
+#include "include/configfile.h"
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+
+/**
+ * @brief Reader and writer of one kind of config.
+ *
+ * @details The format is looked up once per file by the config name, so parsing and serializing loops have no checks
+ * of which config they handle. Support for another Akashi file is a new format added to the registry.
+ *
+ * @see ConfigFile
+ */
+class ConfigFormat
+{
+  public:
+    virtual ~ConfigFormat() = default;
+
+    /**
+     * @brief Get the items of the config file contents.
+     *
+     * @param ok Set to false if the contents are malformed.
+     */
+    virtual QVector<ConfigEntry> parse(const QByteArray &data, bool *ok) const = 0;
+
+    /**
+     * @brief Get the config file contents of the items.
+     */
+    virtual QByteArray serialize(const QVector<ConfigEntry> &entries) const = 0;
+
+    /**
+     * @brief Check if items of the config have song lengths.
+     */
+    virtual bool hasLengths() const = 0;
+
+    /**
+     * @brief Check if the config can have categories.
+     */
+    virtual bool hasCategories() const = 0;
+
+    /**
+     * @brief Get the format of the config, nullptr if there is none.
+     *
+     * @param key Name of the config, e.g. "/music.json".
+     *
+     * @details Thread-safe, formats are used by workers that load and save configs.
+     */
+    static const ConfigFormat *find(const QString &key);
+
+    /**
+     * @brief Add the format for the config, replacing the previous one. The registry owns the format.
+     *
+     * @details Call it before configs are loaded, the registry isn't locked.
+     */
+    static void add(const QString &key, ConfigFormat *format);
+
+  private:
+    /**
+     * @brief Get the registry with the built-in formats.
+     */
+    static QHash<QString, ConfigFormat *> &registry();
+};
+
+/**
+ * @brief Config with one item per line: backgrounds.txt and characters.txt, or music.txt with categories.
+ */
+class TextListFormat : public ConfigFormat
+{
+  public:
+    /**
+     * @param categories Names without an extension are categories, as in music.txt.
+     */
+    explicit TextListFormat(bool categories) :
+        m_categories(categories)
+    {
+    }
+
+    QVector<ConfigEntry> parse(const QByteArray &data, bool *ok) const override;
+
+    QByteArray serialize(const QVector<ConfigEntry> &entries) const override;
+
+    bool hasLengths() const override { return false; }
+
+    bool hasCategories() const override { return m_categories; }
+
+  private:
+    bool m_categories;
+};
+
+/**
+ * @brief music.json: an array of categories with songs and their lengths.
+ */
+class MusicJsonFormat : public ConfigFormat
+{
+  public:
+    QVector<ConfigEntry> parse(const QByteArray &data, bool *ok) const override;
+
+    QByteArray serialize(const QVector<ConfigEntry> &entries) const override;
+
+    bool hasLengths() const override { return true; }
+
+    bool hasCategories() const override { return true; }
+};
+
+#endif // CONFIGFORMAT_H
@@ -0,0 +1,70 @@
+#ifndef DIFFDIALOG_H
+#define DIFFDIALOG_H
+
+#include "include/configdiff.h"
+#include <QDialog>
+#include <QLabel>
+#include <QMap>
+#include <QTreeWidget>
+
+/**
+ * @brief Dialog showing changes between configs of the workspace and another config folder.
+ *
+ * @details Checked changes can be applied to either side.
+ */
+class DiffDialog : public QDialog
+{
+    Q_OBJECT
+
+  public:
+    /**
+     * @param current Configs of the workspace by their names.
+     *
+     * @param other Configs of the compared folder by their names.
+     */
+    DiffDialog(const QMap<QString, QVector<ConfigEntry>> &current, const QMap<QString, QVector<ConfigEntry>> &other, QWidget *parent = nullptr);
+
+  signals:
+    /**
+     * @brief Emitted with the merged config for the workspace.
+     */
+    void applyToCurrent(QString key, QVector<ConfigEntry> entries);
+
+    /**
+     * @brief Emitted with the merged config for the compared folder.
+     */
+    void applyToOther(QString key, QVector<ConfigEntry> entries);
+
+  private:
+    /**
+     * @brief Compare all configs and list their changes.
+     */
+    void compare();
+
+    /**
+     * @brief Apply checked changes to the workspace or the compared folder and compare again.
+     */
+    void applyChecked(bool to_current);
+
+    /**
+     * @brief Get the description of the change.
+     *
+     * @param old_entries Entries the hunk was compared from, to name its anchor.
+     */
+    static QString describe(const DiffHunk &hunk, const QVector<ConfigEntry> &old_entries);
+
+    QMap<QString, QVector<ConfigEntry>> m_current;
+
+    QMap<QString, QVector<ConfigEntry>> m_other;
+
+    /**
+     * @brief Changes of each config. Items of the list keep their index here.
+     */
+    QMap<QString, QVector<DiffHunk>> m_hunks;
+
+    QTreeWidget *m_list;
+
+    QLabel *m_summary;
+};
+
+#endif // DIFFDIALOG_H
@@ -0,0 +1,56 @@
+#ifndef DROPSCANNER_H
+#define DROPSCANNER_H
+
+#include <QStringList>
+
+/**
+ * @brief Scanning of dropped files and folders for config items.
+ *
+ * @details Folders are scanned recursively and only supported files are kept. Runs on a worker thread.
+ */
+class DropScanner
+{
+  public:
+    /**
+     * @brief Get songs of dropped paths for music configs.
+     *
+     * @details Every folder with songs becomes a category followed by its songs. Names are relative to the music folder
+     * if the dropped paths are inside it, otherwise relative to the folder containing the dropped one.
+     *
+     * @param music_folder Path to "sounds/music" of the base folder, may be empty.
+     */
+    static QStringList scanMusic(const QStringList &paths, const QString &music_folder);
+
+    /**
+     * @brief Get backgrounds or characters of dropped paths.
+     *
+     * @details Every folder containing images or a char.ini is one item, its subfolders aren't scanned further. A dropped
+     * image adds its folder, other files are skipped. Names are relative to the asset folder if the dropped paths are inside it.
+     *
+     * @param asset_folder Path to "background" or "characters" of the base folder, may be empty.
+     */
+    static QStringList scanFolders(const QStringList &paths, const QString &asset_folder);
+
+    /**
+     * @brief Check whether the file is a song that can be played.
+     */
+    static bool isAudio(const QString &filename);
+
+    /**
+     * @brief Check whether the file is a background position or a character animation.
+     */
+    static bool isImage(const QString &filename);
+
+  private:
+    /**
+     * @brief Check whether the folder is a background or a character, not a folder of them.
+     */
+    static bool isItemFolder(const QString &folder);
+
+    /**
+     * @brief Get the name relative to the root folder if the path is inside it, otherwise relative to the path's folder.
+     */
+    static QString relativeName(const QString &path, const QString &root);
+};
+
+#endif // DROPSCANNER_H
@@ -0,0 +1,11 @@
+#ifndef DURATIONCACHE_H
+#define DURATIONCACHE_H
+
+#include "include/filestampcache.h"
+
+/**
+ * @brief Cache of probed song lengths in seconds, shared by all workspaces.
+ */
+using DurationCache = FileStampCache<double>;
+
+#endif // DURATIONCACHE_H
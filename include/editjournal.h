@@ -0,0 +1,140 @@
+#ifndef EDITJOURNAL_H
+#define EDITJOURNAL_H
+
+#include <QFile>
+#include <QMap>
+#include <QSet>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * @brief Items of one config restored from the journal.
+ */
+struct JournalConfig
+{
+    QVector<int> ids;
+    QStringList names;
+};
+
+/**
+ * @brief Append-only journal of unsaved edits of one config folder.
+ *
+ * @details Edits are buffered and appended in batches by #flush. Each record has its size and checksum,
+ * so a record torn by a crash is detected and everything before it is recovered.
+ * Edits are stored as operations on ids: renames, lengths, removed items and items inserted after an item, so a move is
+ * a removal and an insertion. Only a config replaced as a whole, e.g. by a conversion, is stored as a snapshot.
+ */
+class EditJournal
+{
+  public:
+    explicit EditJournal(const QString &filename);
+
+    /**
+     * @brief Flush buffered edits.
+     */
+    ~EditJournal();
+
+    /**
+     * @brief Remember all items of the config.
+     *
+     * @param lengths Lengths of the items for music.json, empty for other configs.
+     *
+     * @param baseline Whether the snapshot is the saved state, so it isn't an unsaved edit.
+     */
+    void recordSnapshot(const QString &key, const QVector<int> &ids, const QStringList &names, const QStringList &lengths, bool baseline = false);
+
+    /**
+     * @brief Remember the new name of the item.
+     */
+    void recordRename(const QString &key, int id, const QString &name);
+
+    /**
+     * @brief Remember the new length of the song of music.json.
+     */
+    void recordLength(int id, const QString &length);
+
+    /**
+     * @brief Remember items removed from the config.
+     */
+    void recordRemove(const QString &key, const QVector<int> &ids);
+
+    /**
+     * @brief Remember items inserted into the config in order.
+     *
+     * @param after Id of the item they follow in the config, 0 if they're at the start.
+     */
+    void recordInsert(const QString &key, int after, const QVector<int> &ids, const QStringList &names);
+
+    /**
+     * @brief Mark the config for a snapshot before the next flush.
+     */
+    void markDirty(const QString &key);
+
+    /**
+     * @brief Get configs marked for a snapshot and unmark them.
+     */
+    QStringList takeDirty();
+
+    /**
+     * @brief Get the number of recorded edits, it grows with every edit.
+     */
+    int edits() const;
+
+    /**
+     * @brief Get the size of the journal with buffered records in bytes.
+     */
+    qint64 size() const;
+
+    /**
+     * @brief Append buffered records to the file.
+     */
+    bool flush();
+
+    /**
+     * @brief Drop all records, e.g. after the configs are saved.
+     */
+    bool reset();
+
+    /**
+     * @brief Replay the journal onto configs.
+     *
+     * @param configs Items of loaded configs by config name, changed in place.
+     *
+     * @param lengths Lengths of music.json by id, changed in place.
+     *
+     * @param changed Names of replaced or renamed configs.
+     *
+     * @return Number of unsaved edits, -1 if the journal can't be read.
+     */
+    static int replay(const QString &filename, QMap<QString, JournalConfig> *configs, QStringList *lengths, QSet<QString> *changed);
+
+    /**
+     * @brief Get the journal path of the config folder.
+     */
+    static QString location(const QString &config_folder);
+
+  private:
+    enum Type : quint8 {
+        Snapshot,
+        Baseline,
+        Rename,
+        Length,
+        Remove,
+        Insert
+    };
+
+    /**
+     * @brief Add the record with its size and checksum to the buffer.
+     */
+    void append(const QByteArray &payload);
+
+    QFile m_file;
+
+    QByteArray m_buffer;
+
+    QSet<QString> m_dirty;
+
+    int m_edits = 0;
+};
+
+#endif // EDITJOURNAL_H
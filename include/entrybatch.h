@@ -0,0 +1,73 @@
+#ifndef ENTRYBATCH_H
+#define ENTRYBATCH_H
+
+#include <QList>
+#include <QMap>
+#include <QPair>
+#include <QTreeWidget>
+#include <QTreeWidgetItem>
+#include <QVector>
+
+/**
+ * @brief Tree changes over large selections applied as a few range changes of the model.
+ *
+ * @details Deleting or moving items one at a time costs a model signal, a relayout of the view and a shift of the
+ * sibling list per item, which is quadratic over tens of thousands of rows. Selected rows are grouped by their parent
+ * and coalesced into runs instead. A few runs are changed in place, anything more scattered is done by taking all
+ * children of the parent and putting the rest back, which is one removal and one insertion however many runs there
+ * are. Expanded categories stay expanded either way.
+ *
+ * Rows are addressed by their parent's top-level row, -1 for top-level rows, since the configs are two levels deep.
+ */
+class EntryBatch
+{
+  public:
+    /**
+     * @brief Selected rows grouped by the top-level row of their parent, each group sorted.
+     *
+     * @details Rows of a selected category are left out, they go together with it.
+     */
+    static QMap<int, QVector<int>> selectedRows(QTreeWidget *tree);
+
+    /**
+     * @brief Coalesce sorted rows into runs of the first row and the count.
+     */
+    static QVector<QPair<int, int>> runs(const QVector<int> &rows);
+
+    /**
+     * @brief Get the parent item of the group, the invisible root item for -1.
+     */
+    static QTreeWidgetItem *parentItem(QTreeWidget *tree, int parent);
+
+    /**
+     * @brief Delete the sorted rows of the parent together with their children.
+     */
+    static void removeRows(QTreeWidget *tree, int parent, const QVector<int> &rows);
+
+    /**
+     * @brief Take the sorted rows out of the parent without deleting them.
+     *
+     * @return Taken items in order.
+     */
+    static QList<QTreeWidgetItem *> takeRows(QTreeWidget *tree, int parent, const QVector<int> &rows);
+
+    /**
+     * @brief Insert each item right after its row, items of one run stay in order after the run.
+     *
+     * @param rows Sorted rows of the parent, one per item.
+     */
+    static void insertAfterRows(QTreeWidget *tree, int parent, const QVector<int> &rows, const QList<QTreeWidgetItem *> &items);
+
+  private:
+    /**
+     * @brief Replace all children of the parent in one removal and one insertion, previous children aren't deleted.
+     */
+    static void replaceChildren(QTreeWidgetItem *parent, const QList<QTreeWidgetItem *> &children);
+
+    /**
+     * @brief Up to this many runs are changed in place, each run costs a relayout of the view.
+     */
+    static const int MAX_RUNS = 32;
+};
+
+#endif // ENTRYBATCH_H
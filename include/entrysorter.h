@@ -0,0 +1,73 @@
+#ifndef ENTRYSORTER_H
+#define ENTRYSORTER_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * @brief Precomputed sort key of one item.
+ */
+struct SortKey
+{
+    /**
+     * @brief Length or size, zero when sorting by name.
+     */
+    double number = 0;
+
+    /**
+     * @brief Natural name key, empty when sorting by a number.
+     */
+    QString text;
+
+    /**
+     * @brief Items without a length or an asset go last in both directions.
+     */
+    bool missing = false;
+};
+
+/**
+ * @brief Stable parallel sorting of items by precomputed keys.
+ *
+ * @details Chunks are sorted with std::stable_sort in the thread pool and then merged pairwise, also in parallel.
+ * Equal items keep their order, so sorting by one key after another works as expected.
+ */
+class EntrySorter
+{
+  public:
+    enum Criterion {
+        Name,
+        Length,
+        Size
+    };
+
+    /**
+     * @brief Get natural name keys of names in parallel.
+     *
+     * @see #naturalKey
+     */
+    static QVector<SortKey> nameKeys(const QStringList &names);
+
+    /**
+     * @brief Get a key that sorts case-insensitively and numbers by value, so "song2" goes before "song10".
+     */
+    static QString naturalKey(const QString &name);
+
+    /**
+     * @brief Get indexes of keys in the sorted order.
+     */
+    static QVector<int> order(const QVector<SortKey> &keys, bool descending);
+
+  private:
+    /**
+     * @brief Minimal number of keys sorted by one task.
+     */
+    static const int CHUNK_SIZE = 4096;
+
+    /**
+     * @brief Digit runs are padded to this width by zeros.
+     */
+    static const int NUMBER_WIDTH = 20;
+};
+
+#endif // ENTRYSORTER_H
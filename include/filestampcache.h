@@ -0,0 +1,104 @@
+#ifndef FILESTAMPCACHE_H
+#define FILESTAMPCACHE_H
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QReadWriteLock>
+#include <QString>
+
+/**
+ * @brief Cache of values computed from files, e.g. song lengths or content hashes.
+ *
+ * @details Values are keyed by the file path and are valid while its size and modification time are the same.
+ * Thread-safe. The value type must be serializable with QDataStream.
+ */
+template <typename T>
+class FileStampCache
+{
+  public:
+    /**
+     * @brief Get the cached value of the file.
+     *
+     * @return False if the file wasn't cached or has changed since.
+     */
+    bool find(const QString &path, qint64 size, qint64 modified, T *value) const
+    {
+        QReadLocker l_locker(&m_lock);
+        auto l_iter = m_entries.constFind(path);
+        if (l_iter == m_entries.constEnd() || l_iter->size != size || l_iter->modified != modified)
+            return false;
+
+        *value = l_iter->value;
+        return true;
+    }
+
+    /**
+     * @brief Remember the value of the file.
+     */
+    void insert(const QString &path, qint64 size, qint64 modified, const T &value)
+    {
+        QWriteLocker l_locker(&m_lock);
+        m_entries.insert(path, Entry{size, modified, value});
+    }
+
+    /**
+     * @brief Load values saved by the previous session.
+     */
+    bool load(const QString &filename)
+    {
+        QFile l_file(filename);
+        if (!l_file.open(QIODevice::ReadOnly))
+            return false;
+
+        QDataStream l_in(&l_file);
+        quint32 l_count;
+        l_in >> l_count;
+
+        QWriteLocker l_locker(&m_lock);
+        m_entries.reserve(l_count);
+        for (quint32 i = 0; i < l_count && l_in.status() == QDataStream::Ok; i++) {
+            QString l_path;
+            Entry l_entry;
+            l_in >> l_path >> l_entry.size >> l_entry.modified >> l_entry.value;
+            m_entries.insert(l_path, l_entry);
+        }
+
+        return l_in.status() == QDataStream::Ok;
+    }
+
+    /**
+     * @brief Save values for the next session.
+     */
+    bool save(const QString &filename) const
+    {
+        QDir().mkpath(QFileInfo(filename).absolutePath());
+        QFile l_file(filename);
+        if (!l_file.open(QIODevice::WriteOnly))
+            return false;
+
+        QDataStream l_out(&l_file);
+        QReadLocker l_locker(&m_lock);
+        l_out << quint32(m_entries.size());
+        for (auto l_iter = m_entries.cbegin(); l_iter != m_entries.cend(); ++l_iter)
+            l_out << l_iter.key() << l_iter->size << l_iter->modified << l_iter->value;
+
+        return l_out.status() == QDataStream::Ok;
+    }
+
+  private:
+    struct Entry
+    {
+        qint64 size;
+        qint64 modified;
+        T value;
+    };
+
+    mutable QReadWriteLock m_lock;
+
+    QHash<QString, Entry> m_entries;
+};
+
+#endif // FILESTAMPCACHE_H
@@ -0,0 +1,24 @@
+#ifndef FNVHASH_H
+#define FNVHASH_H
+
+#include <QByteArray>
+#include <QString>
+
+/**
+ * @brief FNV-1a hashes for checksums and hash keys, not for anything security related.
+ */
+class FnvHash
+{
+  public:
+    /**
+     * @brief 32-bit FNV-1a hash of the bytes.
+     */
+    static quint32 hash32(const QByteArray &data);
+
+    /**
+     * @brief 64-bit FNV-1a hash of the UTF-16 code units of the text.
+     */
+    static quint64 hash64(const QString &text);
+};
+
+#endif // FNVHASH_H
@@ -0,0 +1,99 @@
+#ifndef FUZZYFINDER_H
+#define FUZZYFINDER_H
+
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Item of a config to search.
+ */
+struct FinderEntry
+{
+    QString name;
+
+    /**
+     * @brief Name of the config, e.g. "/music.json".
+     */
+    QString config;
+
+    /**
+     * @brief Id of the item in its config.
+     */
+    int id;
+};
+
+/**
+ * @brief Found entry and its score. Higher score is a better match.
+ */
+struct FuzzyMatch
+{
+    int index;
+    int score;
+};
+
+/**
+ * @brief Fuzzy subsequence search over items of all configs.
+ *
+ * @details Names are folded to lower case into one contiguous buffer. Entries missing a character of the query are
+ * skipped by a 64-bit character mask, the subsequence is found with SSE2 where available, and chunks of entries are
+ * scored in the thread pool.
+ */
+class FuzzyFinder
+{
+  public:
+    /**
+     * @brief Replace the searched entries.
+     */
+    void setEntries(const QVector<FinderEntry> &entries);
+
+    /**
+     * @brief Find entries containing characters of the query in order.
+     *
+     * @return Best matches, best first.
+     */
+    QVector<FuzzyMatch> find(const QString &query, int limit) const;
+
+    const FinderEntry &entry(int index) const;
+
+    int count() const;
+
+  private:
+    /**
+     * @brief Score the entry or return -1 if it doesn't match.
+     */
+    int score(int index, const ushort *query, int query_size, quint64 query_mask) const;
+
+    /**
+     * @brief Get the character mask of the folded character.
+     */
+    static quint64 mask(ushort c);
+
+    QVector<FinderEntry> m_entries;
+
+    /**
+     * @brief Folded names of all entries one after another.
+     */
+    QVector<ushort> m_folded;
+
+    /**
+     * @brief Start of each entry's name in #m_folded, with the end of the last one at the back.
+     */
+    QVector<int> m_offsets;
+
+    /**
+     * @brief Characters of each entry's name.
+     */
+    QVector<quint64> m_masks;
+
+    /**
+     * @brief Number of entries scored by one task of the thread pool.
+     */
+    static const int CHUNK_SIZE = 16384;
+
+    /**
+     * @brief Longest query that is scored, the rest is ignored.
+     */
+    static const int MAX_QUERY = 64;
+};
+
+#endif // FUZZYFINDER_H
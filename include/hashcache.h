@@ -0,0 +1,12 @@
+#ifndef HASHCACHE_H
+#define HASHCACHE_H
+
+#include "include/filestampcache.h"
+#include <QByteArray>
+
+/**
+ * @brief Cache of content hashes of asset files.
+ */
+using HashCache = FileStampCache<QByteArray>;
+
+#endif // HASHCACHE_H
@@ -0,0 +1,80 @@
+#ifndef LENGTHAUDIT_H
+#define LENGTHAUDIT_H
+
+#include "include/durationcache.h"
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Song of music.json compared with its file.
+ */
+struct LengthCheck
+{
+    enum Problem {
+        None,
+
+        /**
+         * @brief The stored length differs from the file by more than the tolerance.
+         */
+        Differs,
+
+        /**
+         * @brief The stored length is zero or isn't a number.
+         */
+        Zero,
+
+        /**
+         * @brief There is no such file in sounds/music/.
+         */
+        Missing,
+
+        /**
+         * @brief The file can't be decoded, so its length is unknown.
+         */
+        Unreadable
+    };
+
+    int id = 0;
+
+    QString name;
+
+    /**
+     * @brief Length as it's written in the config.
+     */
+    QString stored;
+
+    /**
+     * @brief Length of the file in seconds, 0 if it's unknown.
+     */
+    double actual = 0;
+
+    Problem problem = None;
+
+    /**
+     * @brief The stored length can be replaced by the length of the file.
+     */
+    bool isFixable() const { return (problem == Differs || problem == Zero) && actual > 0; }
+};
+
+/**
+ * @brief Comparing stored song lengths with the files, so Akashi doesn't cut songs off or loop them early.
+ *
+ * @details Each file is probed once however many songs use it. Lengths come from the duration cache when the file
+ * hasn't changed, the rest are probed in parallel and cached.
+ */
+class LengthAudit
+{
+  public:
+    /**
+     * @brief Get songs whose stored lengths are wrong, zero or unknown, in the order of the config.
+     *
+     * @details Blocking, call it from a worker thread. Streams, e.g. "https://...", aren't checked.
+     *
+     * @param music_folder Path of sounds/music/ of the base folder.
+     * @param songs Songs with their ids, names and stored lengths, without categories.
+     * @param tolerance Allowed difference in seconds.
+     */
+    static QVector<LengthCheck> audit(const QString &music_folder, const QVector<LengthCheck> &songs, DurationCache *cache, double tolerance);
+};
+
+#endif // LENGTHAUDIT_H
@@ -0,0 +1,52 @@
+#ifndef LENGTHAUDITDIALOG_H
+#define LENGTHAUDITDIALOG_H
+
+#include "include/lengthaudit.h"
+#include <QDialog>
+#include <QLabel>
+#include <QTreeWidget>
+
+/**
+ * @brief Dialog listing songs whose lengths don't match their files.
+ *
+ * @details Songs with known file lengths can be checked, the dialog is accepted when their lengths should be fixed.
+ */
+class LengthAuditDialog : public QDialog
+{
+    Q_OBJECT
+
+  public:
+    /**
+     * @param total Number of audited songs.
+     * @param elapsed Time of the audit in milliseconds.
+     */
+    LengthAuditDialog(const QVector<LengthCheck> &checks, int total, qint64 elapsed, QWidget *parent = nullptr);
+
+    /**
+     * @brief Get the songs that are checked.
+     */
+    QVector<LengthCheck> checkedSongs() const;
+
+  private:
+    /**
+     * @brief Helper function for getting the name of the problem.
+     */
+    static QString describe(const LengthCheck &check);
+
+    /**
+     * @brief Show the number of problems and checked songs.
+     */
+    void updateSummary();
+
+    QVector<LengthCheck> m_checks;
+
+    int m_total;
+
+    qint64 m_elapsed;
+
+    QTreeWidget *m_list;
+
+    QLabel *m_summary;
+};
+
+#endif // LENGTHAUDITDIALOG_H
@@ -0,0 +1,74 @@
+#ifndef LENGTHPROBER_H
+#define LENGTHPROBER_H
+
+#include "include/bass.h"
+#include "include/durationcache.h"
+#include <QAtomicInt>
+#include <QObject>
+#include <QThreadPool>
+
+/**
+ * @brief Queue of songs whose lengths are probed in parallel.
+ *
+ * @details Each song is opened as a decoding stream of the "no sound" device on a worker thread, so nothing is played,
+ * no sound card is needed and the GUI isn't blocked. MIDI files are read by MidiFile without a synthesizer.
+ * Probed lengths are stored in the duration cache.
+ */
+class LengthProber : public QObject
+{
+    Q_OBJECT
+
+  public:
+    LengthProber(DurationCache *cache, QObject *parent = nullptr);
+    ~LengthProber();
+
+    /**
+     * @brief Add the song to the queue.
+     *
+     * @see #lengthProbed
+     */
+    void probe(const QString &path);
+
+    /**
+     * @brief Get the number of songs that aren't probed yet.
+     */
+    int pending() const;
+
+    /**
+     * @brief Drop queued songs and wait for songs that are probing right now.
+     */
+    void cancel();
+
+    /**
+     * @brief Get the length of the song in seconds, 0 if it can't be decoded. Safe to call on any thread.
+     */
+    static double length(const QString &path);
+
+    /**
+     * @brief Open the song as a decoding stream of the "no sound" device, 0 if it can't be opened. Safe to call on
+     * any thread.
+     *
+     * @param flags Flags added to BASS_STREAM_DECODE, e.g. BASS_SAMPLE_FLOAT.
+     */
+    static HSTREAM openDecoder(const QString &path, DWORD flags = 0);
+
+    /**
+     * @brief Initialize the "no sound" device of BASS once, decoding streams don't need a sound card.
+     */
+    static bool initDecoder();
+
+  signals:
+    /**
+     * @brief Emitted when the song is probed, delivered to the GUI thread.
+     */
+    void lengthProbed(QString path, double length);
+
+  private:
+    DurationCache *m_cache;
+
+    QThreadPool m_pool;
+
+    QAtomicInt m_pending;
+};
+
+#endif // LENGTHPROBER_H
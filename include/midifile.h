@@ -0,0 +1,40 @@
+#ifndef MIDIFILE_H
+#define MIDIFILE_H
+
+#include <QByteArray>
+#include <QString>
+
+/**
+ * @brief Standard MIDI file reader for song lengths.
+ *
+ * @details The length is worked out from the tempo map and the last event of all tracks, nothing is synthesized and
+ * no soundfont is needed, unlike with BASSMIDI streams.
+ */
+class MidiFile
+{
+  public:
+    /**
+     * @brief Check if the file is a MIDI file by its suffix, .mid, .midi or .rmi in any case.
+     */
+    static bool isMidi(const QString &path);
+
+    /**
+     * @brief Get the length of the MIDI file in seconds. Safe to call on any thread.
+     *
+     * @param ok Set to false if the file isn't a valid MIDI file.
+     */
+    static double length(const QString &path, bool *ok = nullptr);
+
+    /**
+     * @brief Get the length of the MIDI data in seconds, also of RIFF MIDI (.rmi) files.
+     */
+    static double length(const QByteArray &data, bool *ok = nullptr);
+
+  private:
+    /**
+     * @brief Tempo before the first tempo event, 120 beats per minute.
+     */
+    static const quint32 DEFAULT_TEMPO = 500000;
+};
+
+#endif // MIDIFILE_H
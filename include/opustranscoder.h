@@ -0,0 +1,131 @@
+#ifndef OPUSTRANSCODER_H
+#define OPUSTRANSCODER_H
+
+#include <QObject>
+#include <QProcess>
+#include <QQueue>
+#include <QSet>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * @brief Song to convert, paths are absolute.
+ */
+struct TranscodeJob
+{
+    QString source;
+
+    QString target;
+};
+
+/**
+ * @brief Outcome of converting one song.
+ */
+struct TranscodeResult
+{
+    TranscodeJob job;
+
+    bool ok = false;
+
+    /**
+     * @brief Reason of the failure, e.g. the last line the encoder printed.
+     */
+    QString error;
+
+    qint64 source_size = 0;
+
+    qint64 target_size = 0;
+};
+
+/**
+ * @brief Pool of external encoder processes converting songs to Opus.
+ *
+ * @details The encoder is any command line program, with "{input}" and "{output}" in its arguments replaced by the
+ * paths of each song. At most one process per core runs at once, the rest of the songs wait in the queue. The output
+ * is written next to the target and renamed when the encoder succeeds, so a failed or canceled song leaves no file.
+ */
+class OpusTranscoder : public QObject
+{
+    Q_OBJECT
+
+  public:
+    explicit OpusTranscoder(QObject *parent = nullptr);
+    ~OpusTranscoder();
+
+    /**
+     * @brief Set the encoder command, e.g. "ffmpeg -i {input} -c:a libopus {output}".
+     *
+     * @return False if the command has no "{input}" or "{output}".
+     */
+    bool setCommand(const QString &command);
+
+    /**
+     * @brief Set the maximum number of encoders running at once, the number of cores by default.
+     */
+    void setMaxProcesses(int count);
+
+    /**
+     * @brief Queue the songs and start encoders.
+     *
+     * @details Songs with the same target as a queued or running song are dropped.
+     *
+     * @see #songFinished
+     *
+     * @see #finished
+     */
+    void start(const QVector<TranscodeJob> &jobs);
+
+    /**
+     * @brief Drop queued songs and kill running encoders.
+     */
+    void cancel();
+
+    bool isRunning() const;
+
+    /**
+     * @brief Split the command line into the program and its arguments, respecting double quotes.
+     */
+    static QStringList splitCommand(const QString &command);
+
+    /**
+     * @brief Command used when none is configured.
+     */
+    static const char *DEFAULT_COMMAND;
+
+  signals:
+    /**
+     * @brief Emitted for each converted or failed song.
+     */
+    void songFinished(TranscodeResult result);
+
+    /**
+     * @brief Emitted when the queue is empty and no encoder is running.
+     */
+    void finished();
+
+  private:
+    /**
+     * @brief Start encoders for queued songs while there are free processes.
+     */
+    void startNext();
+
+    /**
+     * @brief Collect the output of the encoder and start the next song.
+     */
+    void processFinished(QProcess *process, const TranscodeJob &job, int exit_code, QProcess::ExitStatus status);
+
+    /**
+     * @brief Get the temporary file the encoder writes to.
+     */
+    static QString partialFile(const QString &target);
+
+    QStringList m_command;
+
+    int m_max_processes;
+
+    QQueue<TranscodeJob> m_queue;
+
+    QList<QProcess *> m_processes;
+};
+
+#endif // OPUSTRANSCODER_H
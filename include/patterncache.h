@@ -0,0 +1,41 @@
+#ifndef PATTERNCACHE_H
+#define PATTERNCACHE_H
+
+#include <QCache>
+#include <QRegularExpression>
+#include <QString>
+
+/**
+ * @brief Compiled glob and regular expression patterns of the search line.
+ *
+ * @details Each pattern is compiled (with JIT where PCRE2 supports it) once and reused while the user types.
+ */
+class PatternCache
+{
+  public:
+    enum Syntax {
+        Glob,
+        Regex
+    };
+
+    explicit PatternCache(int capacity = 64);
+
+    /**
+     * @brief Get the compiled pattern.
+     *
+     * @details Both ignore case, glob patterns match the whole name. Check isValid() of regular expressions.
+     */
+    QRegularExpression pattern(const QString &text, Syntax syntax);
+
+    /**
+     * @brief Convert the glob to the regular expression matching the whole name.
+     *
+     * @details Supports "*", "?" and "[...]" classes, "*" also matches "/".
+     */
+    static QString globToRegex(const QString &glob);
+
+  private:
+    QCache<QString, QRegularExpression> m_patterns;
+};
+
+#endif // PATTERNCACHE_H
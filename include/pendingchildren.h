@@ -0,0 +1,35 @@
+#ifndef PENDINGCHILDREN_H
+#define PENDINGCHILDREN_H
+
+#include <QMetaType>
+#include <QVector>
+
+/**
+ * @brief Songs of a collapsed category that have no items yet.
+ *
+ * @details Stored in the category's item and turned into items when the category is expanded for the first time.
+ * They come before songs that were dropped into the category while it was collapsed.
+ */
+struct PendingChildren
+{
+    /**
+     * @brief Names of the songs as ids of the name pool, songs of big categories share their folder prefixes.
+     *
+     * @see StringPool
+     */
+    QVector<int> names;
+
+    /**
+     * @brief Ids of the songs, displayed in the first column.
+     */
+    QVector<int> ids;
+};
+
+Q_DECLARE_METATYPE(PendingChildren)
+
+/**
+ * @brief Item data role for PendingChildren of a category.
+ */
+const int PendingChildrenRole = Qt::UserRole + 1;
+
+#endif // PENDINGCHILDREN_H
@@ -1,11 +1,41 @@
 #ifndef PROGRAM_H
 #define PROGRAM_H
 
+#include "include/animationcache.h"
+#include "include/assetindex.h"
+#include "include/assetmanifest.h"
 #include "include/bass.h"
 #include "include/bassmidi.h"
 #include "include/bassopus.h" // stfu clangd pls
+#include "include/bulkrename.h"
+#include "include/configfile.h"
+#include "include/durationcache.h"
+#include "include/editjournal.h"
+#include "include/entrysorter.h"
+#include "include/fuzzyfinder.h"
+#include "include/lengthaudit.h"
+#include "include/lengthprober.h"
+#include "include/opustranscoder.h"
+#include "include/hashcache.h"
+#include "include/patterncache.h"
+#include "include/pendingchildren.h"
+#include "include/stringpool.h"
+#include "include/unusedassets.h"
+#include "include/waveformcache.h"
+#include "include/waveformwidget.h"
+#include "include/workspace.h"
 #include "ui_program.h"
+#include <QElapsedTimer>
+#include <QFileSystemWatcher>
+#include <QFutureWatcher>
 #include <QMainWindow>
+#include <QMultiHash>
+#include <QSet>
+#include <QTabBar>
+#include <functional>
+#include <QTimer>
+#include <QUndoGroup>
+#include <atomic>
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -22,19 +52,40 @@ class Program : public QMainWindow
     ~Program();
 
     /**
-     * @brief Open the folder with configs and load them.
+     * @brief Open the folder with configs and load them into the current workspace.
      *
-     * @see #m_config_folder
-     *
-     * @see #m_music_length
+     * @see #m_workspace
      */
     void openConfigFolderClicked();
 
+    /**
+     * @brief Start loading configs of the folder into the current workspace.
+     *
+     * @details Configs are read concurrently in background, the workspace keeps its configs until all of them are read.
+     *
+     * @see #loadFinished
+     */
+    void loadConfigFolder(const QString &folder);
+
+    /**
+     * @brief Replace configs of the workspace with the loaded ones at once.
+     */
+    void loadFinished(Workspace *workspace, const QString &folder);
+
+    /**
+     * @brief Stop loading configs into the current workspace, e.g. if the wrong folder was picked.
+     */
+    void cancelLoadingClicked();
+
     /**
      * @brief Open the folder with assets. That need for some functions.
      *
+     * @details The folder is indexed in background for all workspaces.
+     *
      * @see #m_base_folder
      *
+     * @see #m_asset_index
+     *
      * @see #onItemClicked
      *
      * @see getLengthButtonPressed
@@ -43,11 +94,222 @@ class Program : public QMainWindow
      */
     void openBaseFolderClicked();
 
+    /**
+     * @brief Start indexing the base folder in background.
+     */
+    void scanBaseFolder();
+
     /**
      * @brief Save and override configs.
+     *
+     * @details Configs are copied and written concurrently in background, editing isn't blocked.
+     *
+     * @see #saveFinished
      */
     void saveButtonPressed();
 
+    /**
+     * @brief Report configs that can't be saved, or compact the journal if all of them are saved.
+     */
+    void saveFinished();
+
+    /**
+     * @brief Write configs of all workspaces and the asset index into the session snapshot.
+     *
+     * @see SessionSnapshot
+     */
+    void saveSession();
+
+    /**
+     * @brief Reopen workspaces of the previous session from its snapshot.
+     *
+     * @details Workspaces whose config files were changed since are loaded from disk, the asset index is rescanned if
+     * files were added or removed.
+     */
+    void restoreSession();
+
+    /**
+     * @brief Offer to restore unsaved edits of the opened config folder from its journal.
+     *
+     * @see EditJournal
+     */
+    void recoverJournal(Workspace *workspace);
+
+    /**
+     * @brief Start the journal of the workspace from its saved configs.
+     *
+     * @see #m_save_configs
+     */
+    void compactJournal(Workspace *workspace);
+
+    /**
+     * @brief Helper function for writing all items of the config into the journal.
+     */
+    void journalSnapshot(Workspace *workspace, const QString &key);
+
+    /**
+     * @brief Mark the config for a snapshot when it's replaced as a whole.
+     */
+    void journalChanged(QTreeWidget *tree);
+
+    /**
+     * @brief Write reordered songs of the category that aren't created yet into the journal.
+     */
+    void journalReordered(Workspace *workspace, const QString &key, int category, const PendingChildren &children);
+
+    /**
+     * @brief Write the new name of the item into the journal.
+     */
+    void journalRenamed(QTreeWidgetItem *item, int column);
+
+    /**
+     * @brief Write inserted rows, or rows about to be removed, into the journal and the usage index.
+     */
+    void rowsChanged(QTreeWidget *tree, const QModelIndex &parent, int first, int last, bool added);
+
+    /**
+     * @brief Get the id of the last entry of the item, the item itself if it has no songs.
+     */
+    int lastEntryId(QTreeWidgetItem *item);
+
+    /**
+     * @brief Replace the old name of the item edited in place by the new one in the usage index.
+     */
+    void usageRenamed(QTreeWidgetItem *item, int column);
+
+    /**
+     * @brief Write the new length of the song into the journal.
+     */
+    void journalLength(Workspace *workspace, int id);
+
+    /**
+     * @brief Write buffered edits of all workspaces into their journals.
+     *
+     * @see #m_journal_timer
+     */
+    void flushJournals();
+
+    /**
+     * @brief Helper function for getting the workspace of the tree, nullptr if it's closed.
+     */
+    Workspace *treeWorkspace(QTreeWidget *tree);
+
+    /**
+     * @brief Get another workspace with the config folder open, nullptr if there is none.
+     */
+    Workspace *folderWorkspace(const QString &folder, const Workspace *except);
+
+    /**
+     * @brief Index areas.ini and other ini files of the config folder, and watch them for changes.
+     *
+     * @see UsageIndex
+     */
+    void loadIniFiles(Workspace *workspace);
+
+    /**
+     * @brief Stop watching indexed ini files of the workspace, unless another workspace has the same config folder.
+     */
+    void unwatchIniFiles(Workspace *workspace);
+
+    /**
+     * @brief Reindex the changed ini file in workspaces of its folder.
+     */
+    void iniFileChanged(const QString &path);
+
+    /**
+     * @brief Get places that use the asset, after reindexing configs changed since the last lookup.
+     */
+    QVector<AssetUse> assetUses(Workspace *workspace, const QString &asset);
+
+    /**
+     * @brief Helper function for showing uses of the asset, e.g. "areas.ini [0:Basement] background".
+     *
+     * @param skip Config that isn't listed, usually the one the asset is selected in.
+     */
+    QStringList describeUses(const QVector<AssetUse> &uses, const QString &skip);
+
+    /**
+     * @brief Compare configs of the current workspace with another config folder and merge the chosen changes.
+     *
+     * @see DiffDialog
+     */
+    void compareFolderClicked();
+
+    /**
+     * @brief Export the manifest of assets referenced by the configs of the current workspace.
+     *
+     * @details Works only if the base folder is indexed. Assets are hashed in background.
+     *
+     * @see AssetManifest
+     */
+    void exportManifestClicked();
+
+    /**
+     * @brief Check files of a folder against a manifest.
+     *
+     * @see AssetManifest
+     */
+    void verifyManifestClicked();
+
+    /**
+     * @brief Write or verify the manifest when hashing is finished.
+     *
+     * @see #m_manifest_watcher
+     */
+    void manifestFinished();
+
+    /**
+     * @brief Find assets of the base folder that no workspace references, in background.
+     *
+     * @see UnusedAssets
+     */
+    void findUnusedClicked();
+
+    /**
+     * @brief Show unused assets and move the chosen ones to the archive folder.
+     */
+    void unusedFinished();
+
+    /**
+     * @brief Compare lengths of music.json with the song files in background.
+     *
+     * @details Zero lengths and songs without files are reported too, the tolerance is asked first.
+     *
+     * @see LengthAudit
+     */
+    void auditLengthsClicked();
+
+    /**
+     * @brief Show songs with wrong lengths and fix the chosen ones in one pass.
+     */
+    void auditFinished();
+
+    /**
+     * @brief Open a new empty workspace for another config folder.
+     *
+     * @see #m_workspaces
+     */
+    void newWorkspaceClicked();
+
+    /**
+     * @brief Show configs of the workspace selected in the workspace bar.
+     */
+    void workspaceChanged(int index);
+
+    /**
+     * @brief Close the workspace and its configs.
+     *
+     * @details The last workspace can't be closed.
+     */
+    void closeWorkspace(int index);
+
+    /**
+     * @brief Replace the asset index when scanning of the base folder is finished.
+     *
+     * @see #openBaseFolderClicked
+     */
+    void assetIndexFinished();
+
     /**
      * @brief Get a little information about the program.
      */
@@ -56,14 +318,40 @@ class Program : public QMainWindow
     /**
      * @brief Change displayed Background's position/Character's animation when the user change it in pos/anim list.
      *
-     * @details Works only if the base folder is opened
+     * @details Works only if the base folder is opened. Animated files are decoded in background and played when ready.
      *
      * @see #onItemClicked
      *
      * @see #m_base_folder
+     *
+     * @see #m_animation_cache
      */
     void animBgListChanged(QString filename);
 
+    /**
+     * @brief Start playing the animation if it's the displayed one.
+     *
+     * @see #m_animation_path
+     */
+    void animationReady(QString path);
+
+    /**
+     * @brief Show the waveform of the selected song, from the cache or when it's decoded.
+     *
+     * @see #m_waveform_cache
+     */
+    void showWaveform(const QString &path);
+
+    /**
+     * @brief Draw the waveform if it's of the selected song.
+     */
+    void waveformReady(QString path);
+
+    /**
+     * @brief Show the next frame of the displayed animation.
+     */
+    void animationTimeout();
+
     /**
      * @brief Clear displayed config.
      */
@@ -95,23 +383,35 @@ class Program : public QMainWindow
      *
      * @see #m_base_folder
      *
-     * @see #m_music_length
+     * @see Workspace::music_length
      */
     void getLengthButtonPressed();
 
     /**
      * @brief Get length of songs with '0' length using their music file.
      *
-     * @details Works only if the base folder is opened.
+     * @details Works only if the base folder is opened. Songs are probed in background, already probed files are taken from the duration cache.
      *
      * @see #m_base_folder
      *
-     * @see #m_music_length
+     * @see #m_length_prober
      */
     void getLengthsButtonPressed();
 
     /**
-     * @brief Play selected song.
+     * @brief Helper function for adding the song to the probing queue.
+     */
+    void requestLength(Workspace *workspace, int id, const QString &name);
+
+    /**
+     * @brief Set the probed length to songs waiting for it.
+     *
+     * @see #m_length_requests
+     */
+    void lengthProbed(QString path, double length);
+
+    /**
+     * @brief Play selected song from the current position.
      *
      * @details Works only if the base folder is opened.
      *
@@ -120,10 +420,52 @@ class Program : public QMainWindow
     void playButtonPressed();
 
     /**
-     * @brief Stopping play song.
+     * @brief Stopping play song and rewinding it.
      */
     void stopButtonPressed();
 
+    /**
+     * @brief Helper function for opening the selected song in the channel, if it isn't opened yet.
+     *
+     * @details Playback buffering is disabled, so seeks are heard at once.
+     */
+    bool openChannel();
+
+    /**
+     * @brief Move playback of the selected song, in seconds.
+     */
+    void seekTo(double position);
+
+    /**
+     * @brief Show the playback position, polled while the song is playing.
+     *
+     * @see #m_position_timer
+     */
+    void positionTimeout();
+
+    /**
+     * @brief Loop the selected part of the waveform, starting a little before its end to audition the loop point.
+     */
+    void loopToggled(bool checked);
+
+    /**
+     * @brief Move the loop sync of the channel to the selected loop, or remove it if looping is off.
+     */
+    void updateLoop();
+
+    /**
+     * @brief BASS sync jumping from the end of the loop to its start, in the mixer thread.
+     */
+    static void CALLBACK loopSync(HSYNC handle, DWORD channel, DWORD data, void *user);
+
+    /**
+     * @brief Initialize the output device the first time audio is played.
+     *
+     * @details Opening the device is slow and needless for editing backgrounds and characters.
+     * Getting lengths doesn't need it.
+     */
+    bool ensureAudio();
+
     /**
      * @brief Add new category.
      *
@@ -135,11 +477,31 @@ class Program : public QMainWindow
     /**
      * @brief Delete selected items.
      *
-     * @details If delete a category, songs also will deleted.
+     * @details If delete a category, songs also will deleted. Lengths of deleted songs are cleared.
      *
+     * @see EntryBatch
      */
     void deleteButtonPressed();
 
+    /**
+     * @brief Move selected songs to the end of a category picked by the user, in their order in the list.
+     *
+     * @details Works only when selected music.* configs. Categories themselves aren't moved.
+     */
+    void moveToCategoryClicked();
+
+    /**
+     * @brief Put a copy of each selected item with a new id right after it, lengths are copied too.
+     *
+     * @details Categories aren't duplicated.
+     */
+    void duplicateClicked();
+
+    /**
+     * @brief Set one length for all selected songs of music.json.
+     */
+    void setLengthClicked();
+
     /**
      * @brief Change length when the user finished editing.
      *
@@ -150,9 +512,94 @@ class Program : public QMainWindow
 
     /**
      * @brief Change visible items when user using search line.
+     *
+     * @details Depending on the filter mode the text is a substring, a glob or a regular expression.
+     * Glob and regular expression matches are also selected, so they can be deleted or get their lengths.
+     *
+     * @see #m_pattern_cache
      */
     void searchTextChanged(QString text);
 
+    /**
+     * @brief Helper function for getting ids of items matching the search, in parallel.
+     *
+     * @param pattern Pattern to match or an empty one to search for the text.
+     */
+    QSet<int> matchingEntries(QTreeWidget *widget, const QString &text, const QRegularExpression &pattern);
+
+    /**
+     * @brief Open the palette for jumping to any item of backgrounds.txt, characters.txt, music.txt and music.json.
+     *
+     * @see QuickOpenDialog
+     */
+    void quickOpenClicked();
+
+    /**
+     * @brief Show the item in its config and select it.
+     *
+     * @param key Name of the config, e.g. "/music.json".
+     *
+     * @param id Id of the item.
+     */
+    void selectEntry(const QString &key, int id);
+
+    /**
+     * @brief Rename selected items, or all shown items if nothing is selected, by one rule.
+     *
+     * @details The rename is one step of the workspace's undo stack.
+     *
+     * @see BulkRenameDialog
+     */
+    void bulkRenameClicked();
+
+    /**
+     * @brief Convert .mp3, .wav and .ogg songs of music.txt and music.json to Opus with an external encoder.
+     *
+     * @details Songs are converted by a pool of encoder processes, one per core. Pressed again while converting,
+     * it offers to cancel.
+     *
+     * @see OpusTranscoder
+     */
+    void transcodeClicked();
+
+    /**
+     * @brief Carry the cached length over to the converted song and show the progress.
+     */
+    void songTranscoded(TranscodeResult result);
+
+    /**
+     * @brief Rename converted songs in music.txt and music.json as one undoable step, and report saved bytes.
+     */
+    void transcodeFinished();
+
+    /**
+     * @brief Apply or revert renames of the config's items in one pass, including songs of collapsed categories.
+     *
+     * @details Items are matched by id and renamed only if they still have the expected name.
+     *
+     * @see RenameCommand
+     */
+    void renameEntries(Workspace *workspace, const QString &key, const QVector<RenameChange> &changes, bool revert);
+
+    /**
+     * @brief Sort songs of selected categories, or all items of the current config.
+     *
+     * @details Categories keep their places, so songs never move to another category. Items without a length or an asset go last.
+     *
+     * @see EntrySorter
+     */
+    void sortClicked(EntrySorter::Criterion criterion);
+
+    /**
+     * @brief Helper function for sorting tree items.
+     */
+    QList<QTreeWidgetItem *> sortItems(const QList<QTreeWidgetItem *> &items, EntrySorter::Criterion criterion);
+
+    /**
+     * @brief Helper function for getting the sorted order of items by their precomputed keys.
+     */
+    QVector<int> sortOrder(const QVector<int> &ids, const QStringList &names, EntrySorter::Criterion criterion);
+
     /**
      * @brief Helper function for detecting dropping files.
      *
@@ -163,14 +610,110 @@ class Program : public QMainWindow
     /**
      * @brief Helper function for adding dropped files into the config.
      *
+     * @details Dropped folders are scanned recursively in background, subfolders with songs become categories.
+     *
      * @see #dragEnterEvent
+     *
+     * @see DropScanner
      */
     void dropEvent(QDropEvent *event);
 
+    /**
+     * @brief Start adding scanned dropped items.
+     */
+    void dropScanFinished();
+
+    /**
+     * @brief Add the next batch of dropped items, songs of music.json are queued for probing.
+     *
+     * @see #m_drop_timer
+     */
+    void insertDropBatch();
+
     /**
      * @brief Helper function for adding new items into the config.
+     *
+     * @details Only top-level items are created, songs are kept in their category until it's expanded.
+     *
+     * @param ids Ids of the items, by default they follow the greatest id of the config.
+     *
+     * @see #materializeChildren
+     */
+    void addItems(QStringList items, QTreeWidget *widget, Qt::ItemFlags parent_flags, const QVector<int> &ids = QVector<int>());
+
+    /**
+     * @brief Helper function for connecting signals and setting modes of the config's widget.
+     */
+    void setupTree(QTreeWidget *tree);
+
+    /**
+     * @brief Helper function for getting all items of the config with their lengths.
+     *
+     * @param key Name of the config, e.g. "/music.json".
+     */
+    QVector<ConfigEntry> configEntries(const QString &key);
+
+    /**
+     * @brief Helper function for replacing all items of the config.
+     *
+     * @param key Name of the config, e.g. "/music.json".
+     */
+    void setConfigEntries(QString key, QVector<ConfigEntry> entries);
+
+    /**
+     * @brief Helper function for replacing all items of the config in the workspace.
+     */
+    void fillConfig(Workspace *workspace, const QString &key, const QVector<ConfigEntry> &entries);
+
+    /**
+     * @brief Helper function for visiting all items of the config in order, including songs of collapsed categories.
+     *
+     * @param function Called with the id and the name of each item. Names of collapsed songs share one buffer, keep
+     * a copy of the name rather than a reference to it.
+     */
+    void forEachEntry(QTreeWidget *widget, const std::function<void(int, const QString &)> &function);
+
+    /**
+     * @brief Helper function for visiting the item and all its children in order.
      */
-    void addItems(QStringList items, QTreeWidget *widget, Qt::ItemFlags parent_flags);
+    void forEachEntry(QTreeWidgetItem *item, const std::function<void(int, const QString &)> &function);
+
+    /**
+     * @brief Helper function for creating songs of the category.
+     *
+     * @see PendingChildren
+     */
+    void materializeChildren(QTreeWidgetItem *item);
+
+    /**
+     * @brief Helper function for getting songs of the category that have no items yet.
+     */
+    static PendingChildren pendingChildren(const QTreeWidgetItem *item);
+
+    /**
+     * @brief Drop names of the string pool that no song uses anymore and renumber the rest.
+     */
+    void compactStringPool();
+
+    /**
+     * @brief Helper function for storing songs of the category until it's expanded.
+     */
+    static void setPendingChildren(QTreeWidgetItem *item, const PendingChildren &children);
+
+    /**
+     * @brief Helper function for finding the item by its id, songs of collapsed categories are created if needed.
+     */
+    QTreeWidgetItem *findEntry(QTreeWidget *widget, int id);
+
+    /**
+     * @brief Helper function for setting the length of the song by its id.
+     */
+    void setMusicLength(Workspace *workspace, int id, const QString &length);
+
+    /**
+     * @brief Helper function for getting the greatest id in the config.
+     */
+    int lastId(QTreeWidget *widget);
 
     /**
      * @brief Helper function for getting items count in the config.
@@ -187,6 +730,13 @@ class Program : public QMainWindow
      */
     QString getCurrentFolder();
 
+    /**
+     * @brief Helper function for getting the length of the song from the duration cache or its music file.
+     *
+     * @param name Name of the song in the config.
+     */
+    double probeLength(const QString &name);
+
     /**
      * @brief Helper function for getting music to play or getting length.
      */
@@ -198,6 +748,11 @@ class Program : public QMainWindow
      */
     void onItemClicked(QTreeWidgetItem *item);
 
+    /**
+     * @brief Slot for creating songs of the category when it's expanded.
+     */
+    void onItemExpanded(QTreeWidgetItem *item);
+
     /**
      * @brief Slot for edit the item's name.
      */
@@ -207,22 +762,19 @@ class Program : public QMainWindow
     Ui::AkashiAssetConfigEditor *ui;
 
     /**
-     * @brief List of configs and their widgets.
+     * @brief Opened workspaces in order of the workspace bar.
      */
-    QMap<QString, QTreeWidget *> m_configs;
+    QList<Workspace *> m_workspaces;
 
     /**
-     * @brief Path to the folder with configs.
+     * @brief Displayed workspace.
      */
-    QString m_config_folder;
+    Workspace *m_workspace;
 
     /**
-     * @brief List of song length.
-     *
-     * @details For music.json
-     *
+     * @brief Tabs for switching between workspaces.
      */
-    QStringList m_music_length;
+    QTabBar *m_workspace_bar;
 
     /**
      * @brief Flags for creating the common item.
@@ -242,8 +794,311 @@ class Program : public QMainWindow
     QString m_base_folder;
 
     /**
-     * @brief Channel of selected music.
+     * @brief Files of the base folder, shared by all workspaces.
+     */
+    AssetIndex m_asset_index;
+
+    /**
+     * @brief Watcher for scanning of the base folder.
+     */
+    QFutureWatcher<AssetIndex> m_asset_index_watcher;
+
+    /**
+     * @brief Watcher for ini files of opened config folders.
+     */
+    QFileSystemWatcher m_ini_watcher;
+
+    /**
+     * @brief Probed song lengths, shared by all workspaces.
+     */
+    DurationCache m_duration_cache;
+
+    /**
+     * @brief Queue of songs whose lengths are probing in background.
+     */
+    LengthProber m_length_prober;
+
+    /**
+     * @brief Workspaces and ids of songs waiting for lengths, by paths of songs.
+     */
+    QMultiHash<QString, QPair<Workspace *, int>> m_length_requests;
+
+    /**
+     * @brief Watcher for scanning of dropped files.
+     */
+    QFutureWatcher<QStringList> m_drop_watcher;
+
+    /**
+     * @brief Workspace receiving dropped items, nullptr if it was closed.
+     */
+    Workspace *m_drop_workspace = nullptr;
+
+    /**
+     * @brief Config receiving dropped items.
+     */
+    QString m_drop_key;
+
+    /**
+     * @brief Scanned dropped items that aren't added yet.
+     */
+    QStringList m_drop_items;
+
+    /**
+     * @brief Number of added dropped items.
+     */
+    int m_drop_count = 0;
+
+    /**
+     * @brief Timer for adding dropped items in batches between events.
+     */
+    QTimer m_drop_timer;
+
+    /**
+     * @brief Number of dropped items added at once.
+     */
+    static const int DROP_BATCH = 500;
+
+    /**
+     * @brief Watcher for saving configs.
+     */
+    QFutureWatcher<ConfigSaveResult> m_save_watcher;
+
+    /**
+     * @brief Workspace being saved.
+     */
+    Workspace *m_save_workspace = nullptr;
+
+    /**
+     * @brief Items of configs being saved with their ids.
+     */
+    QMap<QString, JournalConfig> m_save_configs;
+
+    /**
+     * @brief Song lengths being saved.
+     */
+    QStringList m_save_lengths;
+
+    /**
+     * @brief Number of journaled edits when saving was started.
+     */
+    int m_save_edits = 0;
+
+    /**
+     * @brief Encoder processes converting songs to Opus.
+     */
+    OpusTranscoder m_transcoder;
+
+    /**
+     * @brief Workspace whose songs are being converted.
+     */
+    Workspace *m_transcode_workspace = nullptr;
+
+    /**
+     * @brief Converted and failed songs of the running conversion.
+     */
+    QVector<TranscodeResult> m_transcode_results;
+
+    /**
+     * @brief Number of songs of the running conversion.
+     */
+    int m_transcode_total = 0;
+
+    /**
+     * @brief Timer for writing edits into journals in batches.
+     */
+    QTimer m_journal_timer;
+
+    /**
+     * @brief Edits aren't journaled while it's above zero, e.g. while loading configs.
+     */
+    int m_journal_paused = 0;
+
+    /**
+     * @brief Item whose name is edited in place, with its name before the edit.
+     */
+    QTreeWidgetItem *m_edited_item = nullptr;
+
+    QString m_edited_name;
+
+    /**
+     * @brief Delay of writing edits into journals in milliseconds.
+     */
+    static const int JOURNAL_DELAY = 500;
+
+    /**
+     * @brief A journal over this many bytes is started again from the current configs.
+     */
+    static const qint64 MAX_JOURNAL_SIZE = 16 * 1024 * 1024;
+
+    /**
+     * @brief The string pool isn't compacted while it's this small.
+     */
+    static const int COMPACT_MIN_NODES = 4096;
+
+    /**
+     * @brief Undo stacks of all workspaces, the active one is the current workspace's.
+     */
+    QUndoGroup m_undo_group;
+
+    /**
+     * @brief Compiled patterns of the search line.
+     */
+    PatternCache m_pattern_cache;
+
+    /**
+     * @brief Items of all configs for the quick open palette.
+     */
+    FuzzyFinder m_finder;
+
+    /**
+     * @brief Content hashes of assets for manifests.
+     */
+    HashCache m_hash_cache;
+
+    /**
+     * @brief Watcher for hashing of assets.
+     */
+    QFutureWatcher<ManifestEntry> m_manifest_watcher;
+
+    /**
+     * @brief Path to the exported manifest, empty when verifying.
+     */
+    QString m_manifest_file;
+
+    /**
+     * @brief Entries of the verified manifest.
+     */
+    QVector<ManifestEntry> m_manifest_expected;
+
+    /**
+     * @brief Time of hashing of assets.
+     */
+    QElapsedTimer m_manifest_timer;
+
+    /**
+     * @brief Watcher for finding of unused assets.
+     */
+    QFutureWatcher<QVector<UnusedAsset>> m_unused_watcher;
+
+    /**
+     * @brief Time of finding of unused assets.
+     */
+    QElapsedTimer m_unused_timer;
+
+    /**
+     * @brief Watcher for auditing of song lengths.
+     */
+    QFutureWatcher<QVector<LengthCheck>> m_audit_watcher;
+
+    /**
+     * @brief Time of auditing of song lengths.
+     */
+    QElapsedTimer m_audit_timer;
+
+    /**
+     * @brief Workspace whose songs are audited, nullptr if it's closed.
+     */
+    Workspace *m_audit_workspace = nullptr;
+
+    /**
+     * @brief Number of audited songs.
+     */
+    int m_audit_total = 0;
+
+    /**
+     * @brief Channel of played music.
+     */
+    DWORD m_channel = 0;
+
+    /**
+     * @brief Path of selected music.
+     */
+    QString m_channel_path;
+
+    /**
+     * @brief Path of music opened in the channel.
+     */
+    QString m_channel_loaded;
+
+    /**
+     * @brief Timer for polling the playback position.
+     */
+    QTimer m_position_timer;
+
+    /**
+     * @brief Interval of polling the playback position in milliseconds.
+     */
+    static const int POSITION_INTERVAL = 30;
+
+    /**
+     * @brief Sync of the loop end, 0 if looping is off.
+     */
+    HSYNC m_loop_sync = 0;
+
+    /**
+     * @brief Loop start in bytes of the channel, read by #loopSync on the mixer thread of BASS.
+     */
+    std::atomic<QWORD> m_loop_start{0};
+
+    /**
+     * @brief Seconds played before the loop end when looping is turned on.
+     */
+    static constexpr double LOOP_LEAD = 3.0;
+
+    /**
+     * @brief BASS output device, -1 until audio is needed.
+     *
+     * @see #ensureAudio
+     */
+    int m_audio_device = -1;
+
+    /**
+     * @brief Startup time that shouldn't be exceeded, in milliseconds.
+     */
+    static const int STARTUP_BUDGET = 300;
+
+    /**
+     * @brief Decoded frames of viewed Background's positions/Character's animations.
+     *
+     * @details Capped at 64 MB of frames.
+     */
+    AnimationCache *m_animation_cache;
+
+    /**
+     * @brief Names of songs of collapsed categories and shared song lengths of all workspaces.
+     */
+    StringPool m_string_pool;
+
+    /**
+     * @brief Waveforms of selected songs, also saved on disk.
+     *
+     * @details Capped at 16 MB in memory.
+     */
+    WaveformCache *m_waveform_cache;
+
+    /**
+     * @brief Waveform strip of the selected song.
+     */
+    WaveformWidget *m_waveform;
+
+    /**
+     * @brief Path of the song whose waveform is shown.
+     */
+    QString m_waveform_path;
+
+    /**
+     * @brief Path of the displayed animation.
+     */
+    QString m_animation_path;
+
+    /**
+     * @brief Index of the displayed frame.
+     */
+    int m_animation_frame = 0;
+
+    /**
+     * @brief Timer for switching frames of the displayed animation.
      */
-    DWORD m_channel;
+    QTimer m_animation_timer;
 };
 #endif // PROGRAM_H
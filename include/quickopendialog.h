@@ -0,0 +1,51 @@
+#ifndef QUICKOPENDIALOG_H
+#define QUICKOPENDIALOG_H
+
+#include "include/fuzzyfinder.h"
+#include <QDialog>
+#include <QLabel>
+#include <QLineEdit>
+#include <QListWidget>
+
+/**
+ * @brief Palette for jumping to any item of any config by a fuzzy query.
+ */
+class QuickOpenDialog : public QDialog
+{
+    Q_OBJECT
+
+  public:
+    QuickOpenDialog(const FuzzyFinder *finder, QWidget *parent = nullptr);
+
+    /**
+     * @brief Get the index of the picked entry in the finder, -1 if nothing is picked.
+     */
+    int selectedIndex() const;
+
+  protected:
+    /**
+     * @brief Move through results with arrow keys while typing.
+     */
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+  private:
+    /**
+     * @brief Show best matches of the query.
+     */
+    void queryChanged(QString query);
+
+    const FuzzyFinder *m_finder;
+
+    QLineEdit *m_query;
+
+    QListWidget *m_results;
+
+    QLabel *m_status;
+
+    /**
+     * @brief Number of shown results.
+     */
+    static const int MAX_RESULTS = 200;
+};
+
+#endif // QUICKOPENDIALOG_H
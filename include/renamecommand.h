@@ -0,0 +1,34 @@
+#ifndef RENAMECOMMAND_H
+#define RENAMECOMMAND_H
+
+#include "include/bulkrename.h"
+#include "include/workspace.h"
+#include <QUndoCommand>
+
+class Program;
+
+/**
+ * @brief Undoable rename of many items of one config.
+ *
+ * @see Program::renameEntries
+ */
+class RenameCommand : public QUndoCommand
+{
+  public:
+    RenameCommand(Program *program, Workspace *workspace, const QString &key, const QVector<RenameChange> &changes);
+
+    void undo() override;
+
+    void redo() override;
+
+  private:
+    Program *m_program;
+
+    Workspace *m_workspace;
+
+    QString m_key;
+
+    QVector<RenameChange> m_changes;
+};
+
+#endif // RENAMECOMMAND_H
@@ -0,0 +1,54 @@
+#ifndef RENAMEPREVIEWMODEL_H
+#define RENAMEPREVIEWMODEL_H
+
+#include <QAbstractTableModel>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * @brief Table of old names, new names and their problems for the bulk rename preview.
+ *
+ * @details Rows are produced on demand by the view, so the preview of thousands of names costs only the visible rows.
+ */
+class RenamePreviewModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+  public:
+    enum Status {
+        Unchanged,
+        Renamed,
+        MissingAsset,
+        Duplicate,
+        EmptyName,
+
+        /**
+         * @brief Like Duplicate, but the config may list a song several times, so it doesn't block the rename.
+         */
+        Repeated
+    };
+
+    explicit RenamePreviewModel(QObject *parent = nullptr);
+
+    /**
+     * @brief Replace the shown preview.
+     */
+    void setPreview(const QStringList &old_names, const QVector<QString> &new_names, const QVector<Status> &statuses);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+  private:
+    QStringList m_old_names;
+
+    QVector<QString> m_new_names;
+
+    QVector<Status> m_statuses;
+};
+
+#endif // RENAMEPREVIEWMODEL_H
@@ -0,0 +1,70 @@
+#ifndef SESSIONSNAPSHOT_H
+#define SESSIONSNAPSHOT_H
+
+#include "include/assetindex.h"
+#include "include/editjournal.h"
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * @brief Parsed configs of one workspace in the session snapshot.
+ */
+struct SessionWorkspace
+{
+    QString config_folder;
+
+    /**
+     * @brief Sizes and modification times of the config files when they were loaded or saved.
+     */
+    QMap<QString, AssetInfo> stamps;
+
+    /**
+     * @brief Items of configs with their ids.
+     */
+    QMap<QString, JournalConfig> configs;
+
+    QStringList music_length;
+};
+
+/**
+ * @brief Compact binary snapshot of the session for fast reopening.
+ *
+ * @details Keeps parsed configs of all workspaces and the asset index, so they don't have to be parsed and scanned again.
+ * The file is read through a memory map. Callers validate the content against the files on disk.
+ */
+class SessionSnapshot
+{
+  public:
+    /**
+     * @brief Write the snapshot.
+     *
+     * @param index Asset index of the base folder, may be empty.
+     */
+    static bool write(const QString &filename, const AssetIndex &index, const QVector<SessionWorkspace> &workspaces);
+
+    /**
+     * @brief Read the snapshot written by #write.
+     *
+     * @return False if the snapshot doesn't exist, is damaged or written by another version.
+     */
+    static bool read(const QString &filename, AssetIndex *index, QVector<SessionWorkspace> *workspaces);
+
+    /**
+     * @brief Get the size and modification time of the file, invalid if it doesn't exist.
+     */
+    static AssetInfo stamp(const QString &path);
+
+    /**
+     * @brief Get the path of the snapshot.
+     */
+    static QString location();
+
+  private:
+    static const quint32 MAGIC = 0x41414345; // "AACE"
+
+    static const quint32 VERSION = 1;
+};
+
+#endif // SESSIONSNAPSHOT_H
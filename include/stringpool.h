@@ -0,0 +1,112 @@
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Interned entry names stored as a trie of path segments in one arena.
+ *
+ * @details A name like "Ace Attorney/Investigation/song.opus" is a chain of three segments, and songs of one folder
+ * share the nodes of its prefix. Text of all segments is kept in one array, a node is its parent and its offset in
+ * the array, and nodes are found by an open addressing table of node indices, so a name costs its last segment's text
+ * and about 16 bytes instead of a QString of its whole path. Equal names get equal ids, so names are compared as
+ * integers. Ids stay valid until #compact. Const functions can be called from several threads while nothing is added.
+ */
+class StringPool
+{
+  public:
+    /**
+     * @brief Get the id of the name, adding it if it's new.
+     */
+    int intern(const QString &name);
+
+    /**
+     * @brief Get the id of the name, -1 if it isn't in the pool.
+     */
+    int find(const QString &name) const;
+
+    /**
+     * @brief Get the name of the id.
+     */
+    QString name(int id) const;
+
+    /**
+     * @brief Write the name of the id into the buffer.
+     *
+     * @details The buffer's memory is reused, so names can be visited one by one without allocating each.
+     */
+    void name(int id, QString *buffer) const;
+
+    /**
+     * @brief Check if the id is of the name without building the name.
+     */
+    bool equals(int id, const QString &name) const;
+
+    /**
+     * @brief Get the shared copy of the text, equal texts share one buffer.
+     *
+     * @details For repeated values that aren't paths, e.g. song lengths.
+     */
+    QString shared(const QString &text);
+
+    /**
+     * @brief Drop names that aren't used anymore, e.g. of closed or reloaded configs.
+     *
+     * @return New ids of the used ids.
+     */
+    QHash<int, int> compact(const QSet<int> &used);
+
+    /**
+     * @brief Get the number of nodes in the trie.
+     */
+    int count() const;
+
+    /**
+     * @brief Get the memory of the trie in bytes.
+     */
+    qint64 bytes() const;
+
+  private:
+    struct Node
+    {
+        /**
+         * @brief Node of the folder, -1 for the first segment.
+         */
+        int parent;
+
+        /**
+         * @brief Start of the segment in the arena, it ends where the next node's segment starts.
+         */
+        int offset;
+    };
+
+    /**
+     * @brief Get the slot of the segment in the table, an empty slot if it isn't there.
+     */
+    int slot(int parent, const QChar *segment, int length) const;
+
+    int segmentLength(int node) const;
+
+    /**
+     * @brief Double the table, it's kept at most half full.
+     */
+    void grow();
+
+    static uint hash(int parent, const QChar *segment, int length);
+
+    QVector<QChar> m_text;
+
+    QVector<Node> m_nodes;
+
+    /**
+     * @brief Node indices by the hash of the parent and the segment, -1 for empty slots. The size is a power of two.
+     */
+    QVector<int> m_table;
+
+    QSet<QString> m_shared;
+};
+
+#endif // STRINGPOOL_H
@@ -0,0 +1,73 @@
+#ifndef UNUSEDASSETS_H
+#define UNUSEDASSETS_H
+
+#include "include/assetindex.h"
+#include <QSet>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * @brief Background, character or song that no config references.
+ */
+struct UnusedAsset
+{
+    /**
+     * @brief Path relative to the base folder, e.g. "background/gs4" or "sounds/music/song.opus".
+     */
+    QString path;
+
+    /**
+     * @brief Size of all its files in bytes.
+     */
+    qint64 size = 0;
+
+    int files = 0;
+};
+
+/**
+ * @brief Finding and archiving assets of the base folder that aren't referenced.
+ *
+ * @details Backgrounds and characters are whole folders, songs are single files of sounds/music/. Other sounds
+ * aren't listed in configs, so they are never reported.
+ */
+class UnusedAssets
+{
+  public:
+    /**
+     * @brief Get the asset the indexed path belongs to, empty if configs don't reference such assets.
+     *
+     * @details E.g. "background/gs4" for "background/gs4/defenseempty.png".
+     */
+    static QString assetOf(const QString &path);
+
+    /**
+     * @brief Get paths an item of a config or an ini value can reference, in lower case.
+     *
+     * @details The name can be a background, a character or a song, so all of them are returned.
+     */
+    static QStringList referencedPaths(const QString &name);
+
+    /**
+     * @brief Get assets of the index that aren't referenced, the largest first.
+     *
+     * @details Blocking, call it from a worker thread. The index is split into chunks summed in parallel.
+     *
+     * @param used Lower case paths from #referencedPaths, case is ignored so nothing used on Windows is reported.
+     */
+    static QVector<UnusedAsset> find(const AssetIndex &index, const QSet<QString> &used);
+
+    /**
+     * @brief Move the assets into the archive folder keeping their paths.
+     *
+     * @return Paths that can't be moved.
+     */
+    static QStringList archive(const QString &base_folder, const QVector<UnusedAsset> &assets, const QString &archive_folder);
+
+  private:
+    /**
+     * @brief Number of indexed paths summed by one task.
+     */
+    static const int CHUNK_SIZE = 16384;
+};
+
+#endif // UNUSEDASSETS_H
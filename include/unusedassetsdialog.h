@@ -0,0 +1,49 @@
+#ifndef UNUSEDASSETSDIALOG_H
+#define UNUSEDASSETSDIALOG_H
+
+#include "include/unusedassets.h"
+#include <QDialog>
+#include <QLabel>
+#include <QTreeWidget>
+
+/**
+ * @brief Dialog listing unused assets with their sizes.
+ *
+ * @details The dialog is accepted when checked assets should be moved to the archive folder.
+ */
+class UnusedAssetsDialog : public QDialog
+{
+    Q_OBJECT
+
+  public:
+    /**
+     * @param elapsed Time of the search in milliseconds.
+     */
+    UnusedAssetsDialog(const QVector<UnusedAsset> &assets, qint64 elapsed, QWidget *parent = nullptr);
+
+    /**
+     * @brief Get the assets that are checked.
+     */
+    QVector<UnusedAsset> checkedAssets() const;
+
+    /**
+     * @brief Helper function for showing the size in megabytes.
+     */
+    static QString formatSize(qint64 size);
+
+  private:
+    /**
+     * @brief Show the number and the size of checked assets.
+     */
+    void updateSummary();
+
+    QVector<UnusedAsset> m_assets;
+
+    qint64 m_elapsed;
+
+    QTreeWidget *m_list;
+
+    QLabel *m_summary;
+};
+
+#endif // UNUSEDASSETSDIALOG_H
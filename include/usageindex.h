@@ -0,0 +1,153 @@
+#ifndef USAGEINDEX_H
+#define USAGEINDEX_H
+
+#include <QHash>
+#include <QPair>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * @brief One section of an ini file, e.g. an area of areas.ini.
+ */
+struct IniSection
+{
+    QString name;
+
+    /**
+     * @brief Keys and values in order, comma separated lists are split into several values of one key.
+     */
+    QVector<QPair<QString, QString>> values;
+};
+
+/**
+ * @brief Place that uses an asset.
+ */
+struct AssetUse
+{
+    /**
+     * @brief Config or ini file, e.g. "/music.json" or "areas.ini".
+     */
+    QString source;
+
+    /**
+     * @brief Section of the ini file, empty for configs.
+     */
+    QString section;
+
+    /**
+     * @brief Key of the ini section, empty for configs.
+     */
+    QString key;
+
+    bool operator==(const AssetUse &other) const { return source == other.source && section == other.section && key == other.key; }
+};
+
+/**
+ * @brief Reverse index from asset names to the configs and the ini areas that use them.
+ *
+ * @details Ini files are replaced one at a time. Configs are indexed once and then follow edits by their added and
+ * removed names, a config that can't follow is marked stale and reindexed before the next lookup. Ini values are
+ * indexed verbatim whatever their keys are, only asset names are ever looked up, so Akashi settings that aren't
+ * asset references cost a little memory and nothing else.
+ */
+class UsageIndex
+{
+  public:
+    /**
+     * @brief Read sections of the ini file in order.
+     *
+     * @param ok Set to false if the file can't be read.
+     */
+    static QVector<IniSection> readIni(const QString &filename, bool *ok = nullptr);
+
+    /**
+     * @brief Replace uses of the ini file.
+     *
+     * @param source Name of the file, e.g. "areas.ini".
+     */
+    void setIni(const QString &source, const QVector<IniSection> &sections);
+
+    /**
+     * @brief Replace uses of the config.
+     *
+     * @param key Name of the config, e.g. "/backgrounds.txt".
+     */
+    void setConfig(const QString &key, const QStringList &names);
+
+    /**
+     * @brief Add names of items added to the config, nothing is done if it's stale.
+     */
+    void addNames(const QString &key, const QStringList &names);
+
+    /**
+     * @brief Remove names of items removed from the config, nothing is done if it's stale.
+     *
+     * @details A name stays used while the config lists it elsewhere.
+     */
+    void removeNames(const QString &key, const QStringList &names);
+
+    /**
+     * @brief Forget all uses of the config or the ini file.
+     */
+    void removeSource(const QString &source);
+
+    /**
+     * @brief Mark the config as changed, it's reindexed by the owner before the next lookup.
+     *
+     * @see #takeStale
+     */
+    void invalidate(const QString &key);
+
+    /**
+     * @brief Get changed configs and forget them.
+     */
+    QStringList takeStale();
+
+    /**
+     * @brief Get all places that use the asset.
+     */
+    QVector<AssetUse> uses(const QString &asset) const;
+
+    /**
+     * @brief Get all used asset names.
+     */
+    QStringList assets() const;
+
+    /**
+     * @brief Get names of ini files in the index.
+     */
+    QStringList iniSources() const;
+
+    /**
+     * @brief Drop everything, e.g. when another config folder is loaded.
+     */
+    void clear();
+
+  private:
+    void add(const QString &asset, const AssetUse &use);
+
+    /**
+     * @brief Remove uses of the asset by the source.
+     */
+    void removeUse(const QString &asset, const QString &source);
+
+    /**
+     * @brief Uses of each asset.
+     */
+    QHash<QString, QVector<AssetUse>> m_uses;
+
+    /**
+     * @brief Assets of each source with how many times the source lists them, so a source can be removed without
+     * scanning the whole index.
+     */
+    QHash<QString, QHash<QString, int>> m_sources;
+
+    /**
+     * @brief Configs changed since they were indexed.
+     */
+    QSet<QString> m_stale;
+};
+
+#endif // USAGEINDEX_H
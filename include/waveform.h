@@ -0,0 +1,82 @@
+#ifndef WAVEFORM_H
+#define WAVEFORM_H
+
+#include <QDataStream>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Multi-resolution min/max peaks of a song.
+ *
+ * @details Level 0 has the peaks of every BASE_FRAMES frames, each next level merges pairs of buckets of the previous
+ * one, so any zoom is drawn from the level whose buckets are just smaller than a pixel. All channels go into one
+ * strip. The data is implicitly shared, so copies are cheap.
+ */
+class Waveform
+{
+  public:
+    /**
+     * @brief Decode the song through a BASS decoding channel of the "no sound" device.
+     *
+     * @details Blocking, call it from a worker thread. The waveform is empty if the song can't be decoded.
+     */
+    static Waveform decode(const QString &path);
+
+    bool isEmpty() const;
+
+    /**
+     * @brief Get the length of the song in seconds.
+     */
+    double length() const;
+
+    int levelCount() const;
+
+    int bucketCount(int level) const;
+
+    /**
+     * @brief Get the duration of one bucket of the level in seconds.
+     */
+    double bucketLength(int level) const;
+
+    /**
+     * @brief Get the finest level whose buckets are at least as long as the duration.
+     */
+    int levelFor(double seconds) const;
+
+    /**
+     * @brief Get the lowest and the highest sample of the buckets [first, last] of the level, from -32767 to 32767.
+     */
+    void peak(int level, int first, int last, qint16 *min, qint16 *max) const;
+
+    /**
+     * @brief Write the waveform for the disk cache.
+     */
+    void write(QDataStream &out) const;
+
+    /**
+     * @brief Read the waveform written by #write.
+     */
+    bool read(QDataStream &in);
+
+  private:
+    /**
+     * @brief Build upper levels from level 0.
+     */
+    void buildLevels();
+
+    /**
+     * @brief Interleaved min and max of each bucket, by level.
+     */
+    QVector<QVector<qint16>> m_levels;
+
+    int m_sample_rate = 0;
+
+    double m_length = 0;
+
+    /**
+     * @brief Number of frames of a level 0 bucket.
+     */
+    static const int BASE_FRAMES = 256;
+};
+
+#endif // WAVEFORM_H
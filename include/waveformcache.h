@@ -0,0 +1,128 @@
+#ifndef WAVEFORMCACHE_H
+#define WAVEFORMCACHE_H
+
+#include "include/waveform.h"
+#include <QAtomicInt>
+#include <QCache>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QObject>
+#include <QSharedPointer>
+#include <QThreadPool>
+
+/**
+ * @brief Cache of waveforms decoded on worker threads, in memory and on disk.
+ *
+ * @details Each waveform is saved into its own file of the cache folder, keyed by the song path, and is valid while
+ * the size and the modification time of the song are the same. Reselecting a song draws it from memory, songs of
+ * previous sessions are read from disk without decoding.
+ *
+ * Songs are decoded by a small pool of their own, so browsing the list doesn't hold up other background work, and
+ * songs that were passed by before their turn came aren't decoded at all. Files written longest ago are removed when
+ * the folder grows over #MAX_DISK_SIZE.
+ */
+class WaveformCache : public QObject
+{
+    Q_OBJECT
+
+  public:
+    /**
+     * @param folder Folder for waveform files.
+     *
+     * @param max_cost_kb Size of waveforms kept in memory.
+     */
+    WaveformCache(const QString &folder, int max_cost_kb, QObject *parent = nullptr);
+    ~WaveformCache();
+
+    /**
+     * @brief Get the waveform if it's in memory.
+     *
+     * @return False if the waveform isn't loaded yet.
+     */
+    bool find(const QString &path, Waveform *waveform) const;
+
+    /**
+     * @brief Start loading the waveform from disk, or decoding it, if it isn't in memory or already loading.
+     *
+     * @see #waveformReady
+     */
+    void request(const QString &path);
+
+    /**
+     * @brief Drop queued requests and wait for the running ones.
+     */
+    void cancel();
+
+  signals:
+    /**
+     * @brief Emitted on the GUI thread when the waveform is in memory.
+     */
+    void waveformReady(QString path);
+
+  private:
+    struct LoadedWaveform
+    {
+        QString path;
+        Waveform waveform;
+
+        /**
+         * @brief Another song was requested before this one started loading.
+         */
+        bool cancelled = false;
+    };
+
+    /**
+     * @brief Read the waveform from disk or decode and save it. Runs on a worker thread.
+     *
+     * @param cancelled Set by the GUI thread when the song isn't wanted anymore.
+     */
+    static LoadedWaveform load(const QString &path, const QString &filename, const QAtomicInt *cancelled);
+
+    /**
+     * @brief Remove files written longest ago until the folder fits into the size. Runs on a worker thread.
+     */
+    static void trim(const QString &folder, qint64 max_size);
+
+    /**
+     * @brief Move the loaded waveform into memory.
+     */
+    void loadFinished(QFutureWatcher<LoadedWaveform> *watcher);
+
+    /**
+     * @brief Get the cache file of the song.
+     */
+    QString filename(const QString &path) const;
+
+    QString m_folder;
+
+    QCache<QString, Waveform> m_cache;
+
+    /**
+     * @brief Paths that are queued or loading right now and their cancel flags.
+     */
+    QHash<QString, QSharedPointer<QAtomicInt>> m_pending;
+
+    /**
+     * @brief Path of the latest request, the only one that is still wanted.
+     */
+    QString m_wanted;
+
+    QThreadPool m_pool;
+
+    /**
+     * @brief Version of waveform files.
+     */
+    static const quint32 VERSION = 1;
+
+    /**
+     * @brief Number of songs decoded at once.
+     */
+    static const int MAX_THREADS = 2;
+
+    /**
+     * @brief Size of the folder of waveform files in bytes.
+     */
+    static const qint64 MAX_DISK_SIZE = 256 * 1024 * 1024;
+};
+
+#endif // WAVEFORMCACHE_H
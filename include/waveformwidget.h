@@ -0,0 +1,95 @@
+#ifndef WAVEFORMWIDGET_H
+#define WAVEFORMWIDGET_H
+
+#include "include/waveform.h"
+#include <QWidget>
+
+/**
+ * @brief Strip with the waveform of the selected song.
+ *
+ * @details The wheel zooms around the cursor, each column is drawn from the pyramid level that fits the zoom.
+ * Clicking or dragging seeks, dragging with Shift selects the loop.
+ */
+class WaveformWidget : public QWidget
+{
+    Q_OBJECT
+
+  public:
+    explicit WaveformWidget(QWidget *parent = nullptr);
+
+    /**
+     * @brief Show the waveform of the whole song.
+     */
+    void setWaveform(const Waveform &waveform);
+
+    /**
+     * @brief Show an empty strip, e.g. while the waveform is decoding.
+     */
+    void clear();
+
+    /**
+     * @brief Move the playback cursor, in seconds.
+     */
+    void setPosition(double position);
+
+    /**
+     * @brief Get the selected loop in seconds, the whole song if nothing is selected.
+     */
+    void loop(double *begin, double *end) const;
+
+  signals:
+    /**
+     * @brief Emitted when the song is clicked or dragged, in seconds.
+     */
+    void seekRequested(double position);
+
+    /**
+     * @brief Emitted when the loop is selected or cleared, in seconds, begin and end are equal when it's cleared.
+     */
+    void loopChanged(double begin, double end);
+
+  protected:
+    void paintEvent(QPaintEvent *event) override;
+
+    void wheelEvent(QWheelEvent *event) override;
+
+    void mousePressEvent(QMouseEvent *event) override;
+
+    void mouseMoveEvent(QMouseEvent *event) override;
+
+  private:
+    /**
+     * @brief Get the time of the column, in seconds.
+     */
+    double timeAt(int x) const;
+
+    /**
+     * @brief Get the column of the time.
+     */
+    int columnAt(double time) const;
+
+    Waveform m_waveform;
+
+    /**
+     * @brief Shown part of the song in seconds.
+     */
+    double m_view_begin = 0;
+
+    double m_view_end = 0;
+
+    double m_position = 0;
+
+    /**
+     * @brief Selected loop in seconds, empty if the loop is the whole song.
+     */
+    double m_loop_begin = 0;
+
+    double m_loop_end = 0;
+
+    /**
+     * @brief Where the selection of the loop started.
+     */
+    double m_loop_anchor = -1;
+};
+
+#endif // WAVEFORMWIDGET_H
@@ -0,0 +1,66 @@
+#ifndef WORKSPACE_H
+#define WORKSPACE_H
+
+#include "include/assetindex.h"
+#include "include/configfile.h"
+#include "include/usageindex.h"
+#include <QFutureWatcher>
+#include <QMap>
+#include <QStringList>
+#include <QTreeWidget>
+#include <QUndoStack>
+
+class EditJournal;
+
+/**
+ * @brief One opened config folder with its own parsed configs.
+ *
+ * @details All workspaces share the base folder, its asset index and the duration cache.
+ */
+struct Workspace
+{
+    /**
+     * @brief Path to the folder with configs.
+     */
+    QString config_folder;
+
+    /**
+     * @brief Sizes and modification times of config files when they were loaded or saved.
+     */
+    QMap<QString, AssetInfo> stamps;
+
+    /**
+     * @brief List of configs and their widgets.
+     */
+    QMap<QString, QTreeWidget *> configs;
+
+    /**
+     * @brief List of song length.
+     *
+     * @details For music.json
+     *
+     */
+    QStringList music_length;
+
+    /**
+     * @brief Undoable edits of the configs.
+     */
+    QUndoStack *undo_stack = nullptr;
+
+    /**
+     * @brief Journal of unsaved edits, nullptr until the config folder is known.
+     */
+    EditJournal *journal = nullptr;
+
+    /**
+     * @brief Configs and ini areas that use each asset.
+     */
+    UsageIndex usage;
+
+    /**
+     * @brief Watcher for configs being loaded, nullptr if nothing is loading.
+     */
+    QFutureWatcher<ConfigLoadResult> *loader = nullptr;
+};
+
+#endif // WORKSPACE_H
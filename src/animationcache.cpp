@@ -0,0 +1,70 @@
+#include "include/animationcache.h"
+#include <QImageReader>
+#include <QtConcurrent>
+
+AnimationCache::AnimationCache(QSize frame_size, int max_cost_kb, QObject *parent) :
+    QObject(parent),
+    m_frame_size(frame_size)
+{
+    m_cache.setMaxCost(max_cost_kb);
+
+    // QCache deletes objects that cost more than all of it right on insertion
+    qint64 l_frame_bytes = qMax<qint64>(qint64(frame_size.width()) * frame_size.height() * 4, 1);
+    m_max_frames = int(qBound<qint64>(1, qint64(max_cost_kb) * 1024 / l_frame_bytes, MAX_FRAMES));
+}
+
+const Animation *AnimationCache::find(const QString &path) const
+{
+    return m_cache.object(path);
+}
+
+void AnimationCache::request(const QString &path)
+{
+    if (m_cache.contains(path) || m_pending.contains(path))
+        return;
+
+    m_pending.insert(path);
+    QFutureWatcher<DecodedFrames> *l_watcher = new QFutureWatcher<DecodedFrames>(this);
+    connect(l_watcher, &QFutureWatcher<DecodedFrames>::finished, this, [this, l_watcher] { decodeFinished(l_watcher); });
+    QSize l_size = m_frame_size;
+    int l_max_frames = m_max_frames;
+    l_watcher->setFuture(QtConcurrent::run([path, l_size, l_max_frames] { return decode(path, l_size, l_max_frames); }));
+}
+
+AnimationCache::DecodedFrames AnimationCache::decode(const QString &path, QSize frame_size, int max_frames)
+{
+    DecodedFrames l_frames;
+    l_frames.path = path;
+
+    QImageReader l_reader(path);
+    while (l_reader.canRead() && l_frames.images.size() < max_frames) {
+        QImage l_image = l_reader.read();
+        if (l_image.isNull())
+            break;
+
+        l_frames.images.append(l_image.scaled(frame_size).convertToFormat(QImage::Format_ARGB32_Premultiplied));
+        l_frames.delays.append(qMax(l_reader.nextImageDelay(), 20)); // Browsers also clamp zero delays
+    }
+
+    return l_frames;
+}
+
+void AnimationCache::decodeFinished(QFutureWatcher<DecodedFrames> *watcher)
+{
+    DecodedFrames l_frames = watcher->result();
+    watcher->deleteLater();
+    m_pending.remove(l_frames.path);
+
+    if (l_frames.images.isEmpty())
+        return;
+
+    Animation *l_animation = new Animation;
+    l_animation->delays = l_frames.delays;
+    l_animation->frames.reserve(l_frames.images.size());
+    for (const QImage &l_image : qAsConst(l_frames.images))
+        l_animation->frames.append(QPixmap::fromImage(l_image));
+
+    int l_cost = qMax(1, l_frames.images.size() * m_frame_size.width() * m_frame_size.height() * 4 / 1024);
+    if (m_cache.insert(l_frames.path, l_animation, l_cost))
+        emit animationReady(l_frames.path);
+}
@@ -0,0 +1,113 @@
+#include "include/assetindex.h"
+#include <QDateTime>
+#include <QDirIterator>
+#include <QFileInfo>
+
+AssetIndex AssetIndex::scan(const QString &base_folder)
+{
+    AssetIndex l_index;
+    l_index.m_base_folder = base_folder;
+
+    const QStringList l_folders{"background", "characters", "sounds"};
+    for (const QString &l_folder : l_folders) {
+        l_index.m_roots.insert(l_folder, folderModified(base_folder + "/" + l_folder));
+        QDirIterator l_iter(base_folder + "/" + l_folder, QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+        while (l_iter.hasNext()) {
+            l_iter.next();
+            QFileInfo l_file = l_iter.fileInfo();
+            AssetInfo l_info;
+            l_info.is_dir = l_file.isDir();
+            l_info.size = l_info.is_dir ? 0 : l_file.size();
+            l_info.modified = l_file.lastModified().toMSecsSinceEpoch();
+            l_index.m_assets.insert(l_iter.filePath().mid(base_folder.length() + 1), l_info);
+        }
+    }
+
+    return l_index;
+}
+
+bool AssetIndex::contains(const QString &path) const
+{
+    return m_assets.contains(path);
+}
+
+AssetInfo AssetIndex::info(const QString &path) const
+{
+    return m_assets.value(path);
+}
+
+QHash<QString, qint64> AssetIndex::folderSizes(const QString &folder) const
+{
+    QHash<QString, qint64> l_sizes;
+    for (auto l_iter = m_assets.cbegin(); l_iter != m_assets.cend(); ++l_iter) {
+        if (l_iter->is_dir || !l_iter.key().startsWith(folder))
+            continue;
+
+        int l_slash = l_iter.key().indexOf('/', folder.length());
+        if (l_slash > 0)
+            l_sizes[l_iter.key().mid(folder.length(), l_slash - folder.length())] += l_iter->size;
+    }
+    return l_sizes;
+}
+
+const QHash<QString, AssetInfo> &AssetIndex::assets() const
+{
+    return m_assets;
+}
+
+QString AssetIndex::baseFolder() const
+{
+    return m_base_folder;
+}
+
+int AssetIndex::count() const
+{
+    return m_assets.size();
+}
+
+bool AssetIndex::isEmpty() const
+{
+    return m_assets.isEmpty();
+}
+
+bool AssetIndex::isCurrent() const
+{
+    for (auto l_iter = m_roots.cbegin(); l_iter != m_roots.cend(); ++l_iter)
+        if (folderModified(m_base_folder + "/" + l_iter.key()) != l_iter.value())
+            return false;
+
+    for (auto l_iter = m_assets.cbegin(); l_iter != m_assets.cend(); ++l_iter)
+        if (l_iter->is_dir && folderModified(m_base_folder + "/" + l_iter.key()) != l_iter->modified)
+            return false;
+
+    return true;
+}
+
+void AssetIndex::write(QDataStream &out) const
+{
+    out << m_base_folder << m_roots << quint32(m_assets.size());
+    for (auto l_iter = m_assets.cbegin(); l_iter != m_assets.cend(); ++l_iter)
+        out << l_iter.key() << l_iter->size << l_iter->modified << l_iter->is_dir;
+}
+
+bool AssetIndex::read(QDataStream &in)
+{
+    quint32 l_count;
+    in >> m_base_folder >> m_roots >> l_count;
+    m_assets.clear();
+    m_assets.reserve(int(qMin<quint32>(l_count, 1 << 20)));
+    for (quint32 i = 0; i < l_count && in.status() == QDataStream::Ok; i++) {
+        QString l_path;
+        AssetInfo l_info;
+        in >> l_path >> l_info.size >> l_info.modified >> l_info.is_dir;
+        m_assets.insert(l_path, l_info);
+    }
+
+    return in.status() == QDataStream::Ok;
+}
+
+qint64 AssetIndex::folderModified(const QString &path)
+{
+    QFileInfo l_folder(path);
+    return l_folder.exists() ? l_folder.lastModified().toMSecsSinceEpoch() : 0;
+}
@@ -0,0 +1,159 @@
+#include "include/assetmanifest.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QSet>
+#include <QtConcurrent>
+#include <algorithm>
+
+namespace {
+/**
+ * @brief Function object for QtConcurrent::mapped, hashing one file.
+ */
+struct HashFile
+{
+    typedef ManifestEntry result_type;
+
+    QString base_folder;
+    HashCache *cache;
+
+    ManifestEntry operator()(const QString &path) const
+    {
+        ManifestEntry l_entry;
+        l_entry.path = path;
+
+        QString l_filename = base_folder + "/" + path;
+        QFileInfo l_info(l_filename);
+        if (!l_info.isFile())
+            return l_entry;
+
+        qint64 l_modified = l_info.lastModified().toMSecsSinceEpoch();
+        l_entry.size = l_info.size();
+        if (cache->find(l_filename, l_entry.size, l_modified, &l_entry.hash))
+            return l_entry;
+
+        QFile l_file(l_filename);
+        QCryptographicHash l_hash(QCryptographicHash::Sha256);
+        if (!l_file.open(QIODevice::ReadOnly) || !l_hash.addData(&l_file)) {
+            l_entry.size = -1;
+            return l_entry;
+        }
+
+        l_entry.hash = l_hash.result();
+        cache->insert(l_filename, l_entry.size, l_modified, l_entry.hash);
+        return l_entry;
+    }
+};
+}
+
+QStringList AssetManifest::referencedAssets(const QMap<QString, QVector<ConfigEntry>> &configs, const AssetIndex &index)
+{
+    QSet<QString> l_backgrounds;
+    for (const ConfigEntry &l_entry : configs.value("/backgrounds.txt"))
+        l_backgrounds.insert(l_entry.name);
+
+    QSet<QString> l_characters;
+    for (const ConfigEntry &l_entry : configs.value("/characters.txt"))
+        l_characters.insert(l_entry.name);
+
+    QSet<QString> l_songs;
+    for (const QString &l_key : {QString("/music.txt"), QString("/music.json")})
+        for (const ConfigEntry &l_entry : configs.value(l_key))
+            if (!ConfigFile::isCategory(l_entry.name))
+                l_songs.insert("sounds/music/" + l_entry.name);
+
+    // One pass over the index: files of used background/<name>/ and characters/<name>/ folders and used songs
+    QStringList l_paths;
+    const QHash<QString, AssetInfo> &l_assets = index.assets();
+    for (auto l_iter = l_assets.cbegin(); l_iter != l_assets.cend(); ++l_iter) {
+        if (l_iter->is_dir)
+            continue;
+
+        const QString &l_path = l_iter.key();
+        int l_slash = l_path.indexOf('/');
+        int l_next_slash = l_path.indexOf('/', l_slash + 1);
+        QString l_folder = l_path.left(l_slash);
+        if (l_folder == "background" && l_next_slash > 0 && l_backgrounds.contains(l_path.mid(l_slash + 1, l_next_slash - l_slash - 1)))
+            l_paths.append(l_path);
+        else if (l_folder == "characters" && l_next_slash > 0 && l_characters.contains(l_path.mid(l_slash + 1, l_next_slash - l_slash - 1)))
+            l_paths.append(l_path);
+        else if (l_folder == "sounds" && l_songs.contains(l_path))
+            l_paths.append(l_path);
+    }
+
+    return l_paths;
+}
+
+QFuture<ManifestEntry> AssetManifest::hash(const QString &base_folder, const QStringList &paths, HashCache *cache)
+{
+    return QtConcurrent::mapped(paths, HashFile{base_folder, cache});
+}
+
+bool AssetManifest::write(const QString &filename, QVector<ManifestEntry> entries)
+{
+    std::sort(entries.begin(), entries.end(), [](const ManifestEntry &a, const ManifestEntry &b) { return a.path < b.path; });
+
+    QByteArray l_data;
+    l_data.reserve(entries.size() * 128);
+    for (const ManifestEntry &l_entry : qAsConst(entries)) {
+        if (l_entry.size < 0)
+            continue;
+
+        l_data += l_entry.hash.toHex() + ' ' + QByteArray::number(l_entry.size) + ' ' + l_entry.path.toUtf8() + '\n';
+    }
+
+    QFile l_file(filename);
+    if (!l_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    return l_file.write(l_data) == l_data.size();
+}
+
+QVector<ManifestEntry> AssetManifest::read(const QString &filename, bool *ok)
+{
+    QVector<ManifestEntry> l_entries;
+    QFile l_file(filename);
+    bool l_ok = l_file.open(QIODevice::ReadOnly);
+    if (ok != nullptr)
+        *ok = l_ok;
+    if (!l_ok)
+        return l_entries;
+
+    const QList<QByteArray> l_lines = l_file.readAll().split('\n');
+    for (const QByteArray &l_line : l_lines) {
+        int l_first = l_line.indexOf(' ');
+        int l_second = l_line.indexOf(' ', l_first + 1);
+        if (l_first < 0 || l_second < 0)
+            continue;
+
+        ManifestEntry l_entry;
+        l_entry.hash = QByteArray::fromHex(l_line.left(l_first));
+        l_entry.size = l_line.mid(l_first + 1, l_second - l_first - 1).toLongLong();
+        l_entry.path = QString::fromUtf8(l_line.mid(l_second + 1));
+        l_entries.append(l_entry);
+    }
+
+    return l_entries;
+}
+
+QStringList AssetManifest::verify(const QVector<ManifestEntry> &expected, const QVector<ManifestEntry> &actual)
+{
+    QHash<QString, const ManifestEntry *> l_actual;
+    l_actual.reserve(actual.size());
+    for (const ManifestEntry &l_entry : actual)
+        l_actual.insert(l_entry.path, &l_entry);
+
+    QStringList l_problems;
+    for (const ManifestEntry &l_entry : expected) {
+        const ManifestEntry *l_file = l_actual.value(l_entry.path);
+        if (l_file == nullptr || l_file->size < 0)
+            l_problems.append(QObject::tr("Missing: %1").arg(l_entry.path));
+        else if (l_file->size != l_entry.size)
+            l_problems.append(QObject::tr("Size differs: %1 (%2 instead of %3 bytes)").arg(l_entry.path).arg(l_file->size).arg(l_entry.size));
+        else if (l_file->hash != l_entry.hash)
+            l_problems.append(QObject::tr("Content differs: %1").arg(l_entry.path));
+    }
+
+    return l_problems;
+}
@@ -0,0 +1,47 @@
+#include "include/bulkrename.h"
+#include <QRegularExpression>
+#include <QtConcurrent>
+
+QVector<QString> BulkRename::apply(const QStringList &names, const RenameRule &rule, QString *error)
+{
+    QVector<QString> l_result(names.size());
+    QString *l_data = l_result.data();
+    if (error != nullptr)
+        error->clear();
+
+    QRegularExpression l_pattern;
+    if (rule.mode == RenameRule::Regex && !rule.find.isEmpty()) {
+        l_pattern.setPattern(rule.find);
+        if (rule.case_sensitivity == Qt::CaseInsensitive)
+            l_pattern.setPatternOptions(QRegularExpression::CaseInsensitiveOption);
+        if (!l_pattern.isValid()) {
+            if (error != nullptr)
+                *error = l_pattern.errorString();
+            for (int i = 0; i < names.size(); i++)
+                l_data[i] = names[i];
+            return l_result;
+        }
+        l_pattern.optimize();
+    }
+
+    QVector<int> l_chunks;
+    for (int i = 0; i < names.size(); i += CHUNK_SIZE)
+        l_chunks.append(i);
+
+    QtConcurrent::blockingMap(l_chunks, [&names, &rule, &l_pattern, l_data](int begin) {
+        QRegularExpression l_chunk_pattern = l_pattern;
+        int l_end = qMin(begin + CHUNK_SIZE, names.size());
+        for (int i = begin; i < l_end; i++) {
+            l_data[i] = names[i];
+            if (rule.find.isEmpty())
+                continue;
+
+            if (rule.mode == RenameRule::Regex)
+                l_data[i].replace(l_chunk_pattern, rule.replace);
+            else
+                l_data[i].replace(rule.find, rule.replace, rule.case_sensitivity);
+        }
+    });
+
+    return l_result;
+}
@@ -0,0 +1,142 @@
+#include "include/bulkrenamedialog.h"
+#include "include/configfile.h"
+#include <QElapsedTimer>
+#include <QFormLayout>
+#include <QHash>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QPushButton>
+#include <QVBoxLayout>
+
+BulkRenameDialog::BulkRenameDialog(const QVector<int> &ids, const QStringList &names, const QSet<QString> &others, const AssetIndex *index, const QString &folder, bool categories, QWidget *parent) :
+    QDialog(parent),
+    m_ids(ids),
+    m_names(names),
+    m_others(others),
+    m_index(index),
+    m_folder(folder),
+    m_categories(categories)
+{
+    setWindowTitle(tr("Rename %1 items").arg(m_names.size()));
+    resize(700, 500);
+
+    m_find = new QLineEdit(this);
+    m_replace = new QLineEdit(this);
+    m_mode = new QComboBox(this);
+    m_mode->addItems({tr("Text"), tr("Regex")});
+    m_case = new QCheckBox(tr("Match case"), this);
+    m_case->setChecked(true);
+
+    m_model = new RenamePreviewModel(this);
+    m_preview = new QTableView(this);
+    m_preview->setModel(m_model);
+    m_preview->setSelectionMode(QAbstractItemView::NoSelection);
+    m_preview->setWordWrap(false);
+    m_preview->verticalHeader()->hide();
+    m_preview->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed); // Rows aren't measured one by one
+    m_preview->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    m_preview->horizontalHeader()->setSectionResizeMode(2, QHeaderView::Fixed);
+    m_preview->horizontalHeader()->resizeSection(2, 100);
+
+    m_status = new QLabel(this);
+    m_buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, this);
+    m_buttons->button(QDialogButtonBox::Ok)->setText(tr("Rename"));
+
+    connect(m_find, &QLineEdit::textChanged, this, &BulkRenameDialog::updatePreview);
+    connect(m_replace, &QLineEdit::textChanged, this, &BulkRenameDialog::updatePreview);
+    connect(m_mode, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &BulkRenameDialog::updatePreview);
+    connect(m_case, &QCheckBox::toggled, this, &BulkRenameDialog::updatePreview);
+    connect(m_buttons, &QDialogButtonBox::accepted, this, &QDialog::accept);
+    connect(m_buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+
+    QHBoxLayout *l_options = new QHBoxLayout;
+    l_options->addWidget(m_mode);
+    l_options->addWidget(m_case);
+    l_options->addStretch();
+
+    QFormLayout *l_rule = new QFormLayout;
+    l_rule->addRow(tr("Find:"), m_find);
+    l_rule->addRow(tr("Replace with:"), m_replace);
+    l_rule->addRow(l_options);
+
+    QVBoxLayout *l_layout = new QVBoxLayout(this);
+    l_layout->addLayout(l_rule);
+    l_layout->addWidget(m_preview);
+    l_layout->addWidget(m_status);
+    l_layout->addWidget(m_buttons);
+
+    updatePreview();
+}
+
+QVector<RenameChange> BulkRenameDialog::changes() const
+{
+    QVector<RenameChange> l_changes;
+    for (int i = 0; i < m_names.size(); i++)
+        if (m_statuses[i] != RenamePreviewModel::Unchanged)
+            l_changes.append(RenameChange{m_ids[i], m_names[i], m_new_names[i]});
+
+    return l_changes;
+}
+
+void BulkRenameDialog::updatePreview()
+{
+    QElapsedTimer l_timer;
+    l_timer.start();
+
+    RenameRule l_rule;
+    l_rule.mode = m_mode->currentIndex() == 0 ? RenameRule::Text : RenameRule::Regex;
+    l_rule.find = m_find->text();
+    l_rule.replace = m_replace->text();
+    l_rule.case_sensitivity = m_case->isChecked() ? Qt::CaseSensitive : Qt::CaseInsensitive;
+
+    QString l_error;
+    m_new_names = BulkRename::apply(m_names, l_rule, &l_error);
+
+    // A new name conflicts if different old names get it, the same song listed twice may keep being one song
+    QHash<QString, QString> l_sources;
+    QSet<QString> l_merged;
+    l_sources.reserve(m_new_names.size());
+    for (int i = 0; i < m_names.size(); i++) {
+        auto l_source = l_sources.constFind(m_new_names[i]);
+        if (l_source == l_sources.constEnd())
+            l_sources.insert(m_new_names[i], m_names[i]);
+        else if (l_source.value() != m_names[i])
+            l_merged.insert(m_new_names[i]);
+    }
+
+    int l_renamed = 0;
+    int l_missing = 0;
+    int l_repeated = 0;
+    int l_errors = 0;
+    m_statuses.resize(m_names.size());
+    for (int i = 0; i < m_names.size(); i++) {
+        const QString &l_name = m_new_names[i];
+        RenamePreviewModel::Status l_status = RenamePreviewModel::Renamed;
+        if (l_name == m_names[i])
+            l_status = RenamePreviewModel::Unchanged;
+        else if (l_name.isEmpty())
+            l_status = RenamePreviewModel::EmptyName;
+        else if (l_merged.contains(l_name) || m_others.contains(l_name))
+            l_status = m_categories && !ConfigFile::isCategory(l_name) ? RenamePreviewModel::Repeated : RenamePreviewModel::Duplicate;
+        else if (!m_index->isEmpty() && !(m_categories && ConfigFile::isCategory(l_name)) && !m_index->contains(m_folder + l_name))
+            l_status = RenamePreviewModel::MissingAsset;
+
+        if (l_status != RenamePreviewModel::Unchanged)
+            l_renamed++;
+        if (l_status == RenamePreviewModel::MissingAsset)
+            l_missing++;
+        if (l_status == RenamePreviewModel::Repeated)
+            l_repeated++;
+        if (l_status == RenamePreviewModel::Duplicate || l_status == RenamePreviewModel::EmptyName)
+            l_errors++;
+        m_statuses[i] = l_status;
+    }
+
+    m_model->setPreview(m_names, m_new_names, m_statuses);
+    m_buttons->button(QDialogButtonBox::Ok)->setEnabled(l_error.isEmpty() && l_errors == 0 && l_renamed > 0);
+
+    if (!l_error.isEmpty())
+        m_status->setText(l_error);
+    else
+        m_status->setText(tr("%1 of %2 items renamed, %3 without assets, %4 listed again, %5 conflicts in %6 ms").arg(l_renamed).arg(m_names.size()).arg(l_missing).arg(l_repeated).arg(l_errors).arg(l_timer.elapsed()));
+}
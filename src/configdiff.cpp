@@ -0,0 +1,286 @@
+#include "include/configdiff.h"
+#include "include/fnvhash.h"
+#include <QHash>
+#include <algorithm>
+
+QVector<DiffHunk> ConfigDiff::compare(const QVector<ConfigEntry> &old_entries, const QVector<ConfigEntry> &new_entries)
+{
+    const int l_old_size = old_entries.size();
+    const int l_new_size = new_entries.size();
+
+    struct Symbol
+    {
+        int old_count = 0;
+        int new_count = 0;
+        int old_index = -1;
+    };
+
+    // Symbol table of hashed keys, the name is the entry's key: whether it's a category also depends only on it
+    QHash<quint64, Symbol> l_symbols;
+    l_symbols.reserve(l_old_size + l_new_size);
+    QVector<quint64> l_old_hashes(l_old_size);
+    QVector<quint64> l_new_hashes(l_new_size);
+    for (int j = 0; j < l_old_size; j++) {
+        l_old_hashes[j] = FnvHash::hash64(old_entries[j].name);
+        Symbol &l_symbol = l_symbols[l_old_hashes[j]];
+        l_symbol.old_count++;
+        l_symbol.old_index = j;
+    }
+
+    for (int i = 0; i < l_new_size; i++) {
+        l_new_hashes[i] = FnvHash::hash64(new_entries[i].name);
+        l_symbols[l_new_hashes[i]].new_count++;
+    }
+
+    QVector<int> l_new_match(l_new_size, -1);
+    QVector<int> l_old_match(l_old_size, -1);
+    auto l_same = [&](int i, int j) {
+        return l_new_hashes[i] == l_old_hashes[j] && new_entries[i].name == old_entries[j].name;
+    };
+    auto l_match = [&](int i, int j) {
+        l_new_match[i] = j;
+        l_old_match[j] = i;
+    };
+
+    // Entries that are unique on both sides match each other
+    for (int i = 0; i < l_new_size; i++) {
+        const Symbol l_symbol = l_symbols.value(l_new_hashes[i]);
+        if (l_symbol.old_count == 1 && l_symbol.new_count == 1 && l_same(i, l_symbol.old_index))
+            l_match(i, l_symbol.old_index);
+    }
+
+    if (l_new_size > 0 && l_old_size > 0) {
+        if (l_new_match[0] < 0 && l_old_match[0] < 0 && l_same(0, 0))
+            l_match(0, 0);
+        if (l_new_match[l_new_size - 1] < 0 && l_old_match[l_old_size - 1] < 0 && l_same(l_new_size - 1, l_old_size - 1))
+            l_match(l_new_size - 1, l_old_size - 1);
+    }
+
+    // Spread matches to equal neighbours, forwards and then backwards
+    for (int i = 0; i < l_new_size - 1; i++) {
+        int j = l_new_match[i];
+        if (j >= 0 && j + 1 < l_old_size && l_new_match[i + 1] < 0 && l_old_match[j + 1] < 0 && l_same(i + 1, j + 1))
+            l_match(i + 1, j + 1);
+    }
+
+    for (int i = l_new_size - 1; i > 0; i--) {
+        int j = l_new_match[i];
+        if (j > 0 && l_new_match[i - 1] < 0 && l_old_match[j - 1] < 0 && l_same(i - 1, j - 1))
+            l_match(i - 1, j - 1);
+    }
+
+    // The longest increasing run of old indices stays in place, other matched entries are moved
+    QVector<int> l_tails;
+    QVector<int> l_tail_indexes;
+    QVector<int> l_previous(l_new_size, -1);
+    for (int i = 0; i < l_new_size; i++) {
+        int j = l_new_match[i];
+        if (j < 0)
+            continue;
+
+        int l_length = std::lower_bound(l_tails.begin(), l_tails.end(), j) - l_tails.begin();
+        if (l_length == l_tails.size()) {
+            l_tails.append(j);
+            l_tail_indexes.append(i);
+        }
+        else {
+            l_tails[l_length] = j;
+            l_tail_indexes[l_length] = i;
+        }
+
+        l_previous[i] = l_length > 0 ? l_tail_indexes[l_length - 1] : -1;
+    }
+
+    QVector<bool> l_stable(l_new_size, false);
+    for (int i = l_tail_indexes.isEmpty() ? -1 : l_tail_indexes.last(); i >= 0; i = l_previous[i])
+        l_stable[i] = true;
+
+    // Deleted and inserted entries in the same gap pair up as renamed ones
+    QVector<int> l_new_renamed(l_new_size, -1);
+    QVector<int> l_old_renamed(l_old_size, -1);
+    int l_old_pos = 0;
+    int l_new_pos = 0;
+    for (int i = 0; i <= l_new_size; i++) {
+        if (i < l_new_size && !l_stable[i])
+            continue;
+
+        int l_old_end = i < l_new_size ? l_new_match[i] : l_old_size;
+        int j = l_old_pos;
+        for (int k = l_new_pos; k < i; k++) {
+            if (l_new_match[k] >= 0)
+                continue;
+
+            while (j < l_old_end && l_old_match[j] >= 0)
+                j++;
+            if (j < l_old_end && ConfigFile::isCategory(old_entries[j].name) == ConfigFile::isCategory(new_entries[k].name)) {
+                l_new_renamed[k] = j;
+                l_old_renamed[j] = k;
+                j++;
+            }
+        }
+
+        l_old_pos = l_old_end + 1;
+        l_new_pos = i + 1;
+    }
+
+    // Nearest previous entry that exists on both sides, as its position on the other side
+    QVector<int> l_old_anchors(l_old_size);
+    int l_anchor = -1;
+    for (int j = 0; j < l_old_size; j++) {
+        l_old_anchors[j] = l_anchor;
+        if (l_old_match[j] >= 0)
+            l_anchor = l_old_match[j];
+        else if (l_old_renamed[j] >= 0)
+            l_anchor = l_old_renamed[j];
+    }
+
+    // Walk the gaps between entries that stay in place
+    QVector<DiffHunk> l_hunks;
+    int l_new_anchor = -1;
+    l_old_pos = 0;
+    l_new_pos = 0;
+    for (int i = 0; i <= l_new_size; i++) {
+        if (i < l_new_size && !l_stable[i])
+            continue;
+
+        l_anchor = l_new_anchor;
+        for (int k = l_new_pos; k < i; k++) {
+            const ConfigEntry &l_entry = new_entries[k];
+            int j = l_new_match[k];
+            if (j >= 0) {
+                l_hunks.append(DiffHunk{DiffHunk::Move, old_entries[j], l_entry, j, k, l_old_anchors[j], l_anchor});
+                if (old_entries[j].length != l_entry.length)
+                    l_hunks.append(DiffHunk{DiffHunk::Length, old_entries[j], l_entry, j, k, l_old_anchors[j], l_anchor});
+                l_anchor = j;
+            }
+            else if (l_new_renamed[k] >= 0) {
+                j = l_new_renamed[k];
+                l_hunks.append(DiffHunk{DiffHunk::Rename, old_entries[j], l_entry, j, k, l_old_anchors[j], l_anchor});
+                l_anchor = j;
+            }
+            else
+                l_hunks.append(DiffHunk{DiffHunk::Insert, ConfigEntry(), l_entry, -1, k, -1, l_anchor});
+        }
+
+        int l_old_end = i < l_new_size ? l_new_match[i] : l_old_size;
+        for (int j = l_old_pos; j < l_old_end; j++)
+            if (l_old_match[j] < 0 && l_old_renamed[j] < 0)
+                l_hunks.append(DiffHunk{DiffHunk::Delete, old_entries[j], ConfigEntry(), j, -1, l_old_anchors[j], -1});
+
+        if (i == l_new_size)
+            break;
+
+        int j = l_new_match[i];
+        if (old_entries[j].length != new_entries[i].length)
+            l_hunks.append(DiffHunk{DiffHunk::Length, old_entries[j], new_entries[i], j, i, l_old_anchors[j], l_new_anchor});
+
+        l_new_anchor = j;
+        l_old_pos = j + 1;
+        l_new_pos = i + 1;
+    }
+
+    return l_hunks;
+}
+
+QVector<ConfigEntry> ConfigDiff::apply(QVector<ConfigEntry> entries, const QVector<DiffHunk> &hunks)
+{
+    // Circular doubly linked list over the entries, node 0 is the head and node k + 1 the entry at position k
+    const int l_size = entries.size() + 1;
+    entries.prepend(ConfigEntry());
+    QVector<int> l_next(l_size);
+    QVector<int> l_prev(l_size);
+    QVector<bool> l_linked(l_size, true);
+    for (int k = 0; k < l_size; k++) {
+        l_next[k] = (k + 1) % l_size;
+        l_prev[k] = (k + l_size - 1) % l_size;
+    }
+
+    auto l_unlink = [&](int node) {
+        l_next[l_prev[node]] = l_next[node];
+        l_prev[l_next[node]] = l_prev[node];
+        l_linked[node] = false;
+    };
+
+    // Entries placed after the same anchor keep their order
+    QHash<int, int> l_last_placed;
+    auto l_place = [&](int node, int anchor) {
+        int l_after = anchor + 1;
+        if (l_after >= l_size || !l_linked[l_after]) // The anchor is gone, append to the end
+            l_after = l_prev[0];
+        int l_last = l_last_placed.value(anchor, -1);
+        if (l_last >= 0 && l_linked[l_last])
+            l_after = l_last;
+
+        l_next[node] = l_next[l_after];
+        l_prev[node] = l_after;
+        l_prev[l_next[l_after]] = node;
+        l_next[l_after] = node;
+        l_linked[node] = true;
+        l_last_placed.insert(anchor, node);
+    };
+
+    for (const DiffHunk &l_hunk : hunks) {
+        if (l_hunk.type == DiffHunk::Insert) {
+            int l_node = entries.size();
+            entries.append(l_hunk.new_entry);
+            l_next.append(l_node);
+            l_prev.append(l_node);
+            l_linked.append(false);
+            l_place(l_node, l_hunk.new_anchor);
+            continue;
+        }
+
+        int l_node = l_hunk.old_index + 1;
+        if (l_node < 1 || l_node >= l_size || !l_linked[l_node] || entries[l_node].name != l_hunk.old_entry.name)
+            continue;
+
+        switch (l_hunk.type) {
+        case DiffHunk::Delete:
+            l_unlink(l_node);
+            break;
+        case DiffHunk::Move:
+            l_unlink(l_node);
+            l_place(l_node, l_hunk.new_anchor);
+            break;
+        case DiffHunk::Rename:
+            entries[l_node].name = l_hunk.new_entry.name;
+            entries[l_node].length = l_hunk.new_entry.length;
+            break;
+        case DiffHunk::Length:
+            entries[l_node].length = l_hunk.new_entry.length;
+            break;
+        default:
+            break;
+        }
+    }
+
+    QVector<ConfigEntry> l_result;
+    l_result.reserve(entries.size() - 1);
+    for (int k = l_next[0]; k != 0; k = l_next[k])
+        l_result.append(entries[k]);
+
+    return l_result;
+}
+
+QVector<ConfigEntry> ConfigDiff::revert(const QVector<ConfigEntry> &entries, const QVector<DiffHunk> &hunks)
+{
+    QVector<DiffHunk> l_hunks;
+    l_hunks.reserve(hunks.size());
+    for (const DiffHunk &l_hunk : hunks)
+        l_hunks.append(inverted(l_hunk));
+
+    // Entries placed after the same anchor must come in order of the old side
+    std::stable_sort(l_hunks.begin(), l_hunks.end(), [](const DiffHunk &a, const DiffHunk &b) { return a.new_index < b.new_index; });
+    return apply(entries, l_hunks);
+}
+
+DiffHunk ConfigDiff::inverted(const DiffHunk &hunk)
+{
+    DiffHunk l_hunk{hunk.type, hunk.new_entry, hunk.old_entry, hunk.new_index, hunk.old_index, hunk.new_anchor, hunk.old_anchor};
+    if (hunk.type == DiffHunk::Insert)
+        l_hunk.type = DiffHunk::Delete;
+    else if (hunk.type == DiffHunk::Delete)
+        l_hunk.type = DiffHunk::Insert;
+
+    return l_hunk;
+}
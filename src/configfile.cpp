@@ -0,0 +1,115 @@
+#include "include/configfile.h"
+#include "include/configformat.h"
+#include <QFile>
+#include <QObject>
+#include <QSaveFile>
+#include <QtConcurrent>
+
+namespace {
+/**
+ * @brief Function object for QtConcurrent::mapped, reading one config.
+ */
+struct ReadConfig
+{
+    typedef ConfigLoadResult result_type;
+
+    QString folder;
+
+    ConfigLoadResult operator()(const QString &key) const
+    {
+        ConfigLoadResult l_result;
+        l_result.key = key;
+        l_result.entries = ConfigFile::read(folder, key, &l_result.ok);
+        return l_result;
+    }
+};
+
+/**
+ * @brief Function object for QtConcurrent::mapped, writing one config.
+ */
+struct WriteConfig
+{
+    typedef ConfigSaveResult result_type;
+
+    QString folder;
+    QMap<QString, QVector<ConfigEntry>> configs;
+
+    ConfigSaveResult operator()(const QString &key) const
+    {
+        ConfigSaveResult l_result;
+        l_result.key = key;
+        l_result.ok = ConfigFile::write(folder, key, configs[key], &l_result.error);
+        return l_result;
+    }
+};
+}
+
+QVector<ConfigEntry> ConfigFile::read(const QString &folder, const QString &key, bool *ok)
+{
+    const ConfigFormat *l_format = ConfigFormat::find(key);
+    QFile l_file(folder + key);
+    bool l_ok = l_format != nullptr && l_file.open(QIODevice::ReadOnly);
+    QVector<ConfigEntry> l_entries;
+    if (l_ok)
+        l_entries = l_format->parse(l_file.readAll(), &l_ok);
+    if (ok != nullptr)
+        *ok = l_ok;
+    return l_entries;
+}
+
+bool ConfigFile::write(const QString &folder, const QString &key, const QVector<ConfigEntry> &entries, QString *error)
+{
+    const ConfigFormat *l_format = ConfigFormat::find(key);
+    if (l_format == nullptr) {
+        if (error != nullptr)
+            *error = QObject::tr("Unknown config");
+        return false;
+    }
+
+    // The old config stays untouched until the new one is completely written
+    QSaveFile l_file(folder + key);
+    l_file.setDirectWriteFallback(true);
+    if (!l_file.open(QIODevice::WriteOnly)) {
+        if (error != nullptr)
+            *error = l_file.errorString();
+        return false;
+    }
+
+    QByteArray l_data = l_format->serialize(entries);
+    if (l_file.write(l_data) != l_data.size() || !l_file.commit()) {
+        if (error != nullptr)
+            *error = l_file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+QFuture<ConfigLoadResult> ConfigFile::readAll(const QString &folder, const QStringList &keys)
+{
+    return QtConcurrent::mapped(keys, ReadConfig{folder});
+}
+
+QFuture<ConfigSaveResult> ConfigFile::writeAll(const QString &folder, const QMap<QString, QVector<ConfigEntry>> &configs)
+{
+    return QtConcurrent::mapped(configs.keys(), WriteConfig{folder, configs});
+}
+
+bool ConfigFile::isCategory(const QString &name)
+{
+    QString l_name = name.left(name.lastIndexOf("."));
+    l_name = l_name.right(l_name.length() - (l_name.lastIndexOf("/") + 1));
+    return l_name == name;
+}
+
+bool ConfigFile::hasLengths(const QString &key)
+{
+    const ConfigFormat *l_format = ConfigFormat::find(key);
+    return l_format != nullptr && l_format->hasLengths();
+}
+
+bool ConfigFile::hasCategories(const QString &key)
+{
+    const ConfigFormat *l_format = ConfigFormat::find(key);
+    return l_format != nullptr && l_format->hasCategories();
+}
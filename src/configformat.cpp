@@ -0,0 +1,118 @@
+#include "include/configformat.h"
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QVariant>
+
+QVector<ConfigEntry> TextListFormat::parse(const QByteArray &data, bool *ok) const
+{
+    QVector<ConfigEntry> l_entries;
+    l_entries.reserve(data.count('\n') + 1);
+    const char *l_data = data.constData();
+    int l_begin = 0;
+    while (l_begin < data.size()) {
+        int l_end = data.indexOf('\n', l_begin);
+        if (l_end < 0)
+            l_end = data.size();
+
+        QString l_name = QString::fromUtf8(l_data + l_begin, l_end - l_begin).trimmed(); // Also drops '\r' of Windows
+        if (!l_name.isEmpty())
+            l_entries.append(ConfigEntry{l_name, QString()});
+        l_begin = l_end + 1;
+    }
+
+    *ok = true;
+    return l_entries;
+}
+
+QByteArray TextListFormat::serialize(const QVector<ConfigEntry> &entries) const
+{
+    QByteArray l_data;
+    l_data.reserve(entries.size() * 32);
+    for (const ConfigEntry &l_entry : entries) {
+        l_data += l_entry.name.toUtf8();
+        l_data += '\n';
+    }
+    return l_data;
+}
+
+QVector<ConfigEntry> MusicJsonFormat::parse(const QByteArray &data, bool *ok) const
+{
+    QVector<ConfigEntry> l_entries;
+    *ok = true;
+    if (data.trimmed().isEmpty()) // An empty file has no songs yet
+        return l_entries;
+
+    QJsonParseError l_error;
+    QJsonArray l_list = QJsonDocument::fromJson(data, &l_error).array();
+    *ok = l_error.error == QJsonParseError::NoError;
+    for (int i = 0; i < l_list.size(); i++) {
+        QJsonObject l_object = l_list.at(i).toObject();
+        QString l_category = l_object["category"].toString();
+        if (!l_category.isEmpty())
+            l_entries.append(ConfigEntry{l_category, "category"});
+
+        QJsonArray l_array = l_object["songs"].toArray();
+        for (int j = 0; j < l_array.size(); j++) {
+            QJsonObject l_music_object = l_array.at(j).toObject();
+            l_entries.append(ConfigEntry{l_music_object["name"].toString(), QString::number(l_music_object["length"].toVariant().toDouble())});
+        }
+    }
+
+    return l_entries;
+}
+
+QByteArray MusicJsonFormat::serialize(const QVector<ConfigEntry> &entries) const
+{
+    QJsonObject l_record_object;
+    QJsonArray l_category_array;
+    QJsonArray l_record_array;
+    QString l_last_category;
+    for (const ConfigEntry &l_entry : entries) {
+        if (ConfigFile::isCategory(l_entry.name) && l_last_category != l_entry.name) {
+            if (!l_record_object.isEmpty() || !l_category_array.isEmpty()) {
+                if (!l_category_array.isEmpty())
+                    l_record_object.insert("songs", l_category_array);
+                l_record_array.push_back(l_record_object);
+                l_record_object = QJsonObject();
+                l_category_array = QJsonArray();
+            }
+
+            l_record_object.insert("category", l_entry.name);
+            l_last_category = l_entry.name;
+        }
+        else
+            l_category_array.push_back(QJsonObject{{"name", l_entry.name}, {"length", l_entry.length}});
+    }
+
+    // Songs are inserted once per category, inserting after each song copies the array every time
+    if (!l_category_array.isEmpty())
+        l_record_object.insert("songs", l_category_array);
+    if (!l_record_object.isEmpty())
+        l_record_array.push_back(l_record_object);
+
+    return QJsonDocument(l_record_array).toJson();
+}
+
+const ConfigFormat *ConfigFormat::find(const QString &key)
+{
+    return registry().value(key);
+}
+
+void ConfigFormat::add(const QString &key, ConfigFormat *format)
+{
+    delete registry().value(key);
+    registry().insert(key, format);
+}
+
+QHash<QString, ConfigFormat *> &ConfigFormat::registry()
+{
+    // Built on first use, that is thread-safe for function statics
+    static QHash<QString, ConfigFormat *> l_registry{
+        {"/backgrounds.txt", new TextListFormat(false)},
+        {"/characters.txt", new TextListFormat(false)},
+        {"/music.txt", new TextListFormat(true)},
+        {"/music.json", new MusicJsonFormat},
+    };
+    return l_registry;
+}
@@ -0,0 +1,116 @@
+#include "include/diffdialog.h"
+#include <QDialogButtonBox>
+#include <QElapsedTimer>
+#include <QHeaderView>
+#include <QPushButton>
+#include <QVBoxLayout>
+
+DiffDialog::DiffDialog(const QMap<QString, QVector<ConfigEntry>> &current, const QMap<QString, QVector<ConfigEntry>> &other, QWidget *parent) :
+    QDialog(parent),
+    m_current(current),
+    m_other(other)
+{
+    setWindowTitle(tr("Compare configs"));
+    resize(700, 500);
+
+    m_summary = new QLabel(this);
+    m_list = new QTreeWidget(this);
+    m_list->setColumnCount(2);
+    m_list->setHeaderLabels({tr("Change"), tr("Entry")});
+    m_list->header()->setSectionResizeMode(0, QHeaderView::ResizeToContents);
+    m_list->setUniformRowHeights(true);
+
+    QDialogButtonBox *l_buttons = new QDialogButtonBox(QDialogButtonBox::Close, this);
+    QPushButton *l_current_button = l_buttons->addButton(tr("Apply to workspace"), QDialogButtonBox::ActionRole);
+    QPushButton *l_other_button = l_buttons->addButton(tr("Apply to compared folder"), QDialogButtonBox::ActionRole);
+    connect(l_current_button, &QPushButton::clicked, this, [this] { applyChecked(true); });
+    connect(l_other_button, &QPushButton::clicked, this, [this] { applyChecked(false); });
+    connect(l_buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+
+    QVBoxLayout *l_layout = new QVBoxLayout(this);
+    l_layout->addWidget(m_summary);
+    l_layout->addWidget(m_list);
+    l_layout->addWidget(l_buttons);
+
+    compare();
+}
+
+void DiffDialog::compare()
+{
+    m_list->clear();
+    m_hunks.clear();
+
+    QElapsedTimer l_timer;
+    l_timer.start();
+    int l_count = 0;
+    for (auto l_iter = m_current.cbegin(); l_iter != m_current.cend(); ++l_iter) {
+        QVector<DiffHunk> l_hunks = ConfigDiff::compare(l_iter.value(), m_other.value(l_iter.key()));
+        m_hunks.insert(l_iter.key(), l_hunks);
+        l_count += l_hunks.size();
+    }
+    qint64 l_elapsed = l_timer.elapsed();
+
+    for (auto l_iter = m_hunks.cbegin(); l_iter != m_hunks.cend(); ++l_iter) {
+        if (l_iter->isEmpty())
+            continue;
+
+        QTreeWidgetItem *l_config = new QTreeWidgetItem(m_list, QStringList{l_iter.key().mid(1), QString::number(l_iter->size())});
+        l_config->setFlags(l_config->flags() | Qt::ItemIsUserCheckable | Qt::ItemIsAutoTristate);
+        l_config->setCheckState(0, Qt::Unchecked);
+        for (int i = 0; i < l_iter->size(); i++) {
+            const DiffHunk &l_hunk = l_iter->at(i);
+            QTreeWidgetItem *l_item = new QTreeWidgetItem(l_config, QStringList{describe(l_hunk, m_current[l_iter.key()]), l_hunk.type == DiffHunk::Delete ? l_hunk.old_entry.name : l_hunk.new_entry.name});
+            l_item->setFlags(l_item->flags() | Qt::ItemIsUserCheckable);
+            l_item->setCheckState(0, Qt::Unchecked);
+            l_item->setData(0, Qt::UserRole, i);
+        }
+    }
+
+    m_summary->setText(tr("%1 changes found in %2 ms. Changes turn the workspace into the compared folder.").arg(l_count).arg(l_elapsed));
+}
+
+void DiffDialog::applyChecked(bool to_current)
+{
+    for (int i = 0; i < m_list->topLevelItemCount(); i++) {
+        QTreeWidgetItem *l_config = m_list->topLevelItem(i);
+        QString l_key = "/" + l_config->text(0);
+        const QVector<DiffHunk> &l_all_hunks = m_hunks[l_key];
+        QVector<DiffHunk> l_hunks;
+        for (int j = 0; j < l_config->childCount(); j++)
+            if (l_config->child(j)->checkState(0) == Qt::Checked)
+                l_hunks.append(l_all_hunks[l_config->child(j)->data(0, Qt::UserRole).toInt()]);
+
+        if (l_hunks.isEmpty())
+            continue;
+
+        if (to_current) {
+            m_current[l_key] = ConfigDiff::apply(m_current[l_key], l_hunks);
+            emit applyToCurrent(l_key, m_current[l_key]);
+        }
+        else {
+            m_other[l_key] = ConfigDiff::revert(m_other[l_key], l_hunks);
+            emit applyToOther(l_key, m_other[l_key]);
+        }
+    }
+
+    compare();
+}
+
+QString DiffDialog::describe(const DiffHunk &hunk, const QVector<ConfigEntry> &old_entries)
+{
+    QString l_anchor = hunk.new_anchor >= 0 && hunk.new_anchor < old_entries.size() ? old_entries[hunk.new_anchor].name : QString();
+    switch (hunk.type) {
+    case DiffHunk::Insert:
+        return tr("Insert after \"%1\"").arg(l_anchor);
+    case DiffHunk::Delete:
+        return tr("Delete");
+    case DiffHunk::Move:
+        return tr("Move after \"%1\"").arg(l_anchor);
+    case DiffHunk::Rename:
+        return tr("Rename from \"%1\"").arg(hunk.old_entry.name);
+    case DiffHunk::Length:
+        return tr("Length %1 -> %2").arg(hunk.old_entry.length, hunk.new_entry.length);
+    }
+
+    return QString();
+}
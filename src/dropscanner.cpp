@@ -0,0 +1,112 @@
+#include "include/dropscanner.h"
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QMap>
+
+QStringList DropScanner::scanMusic(const QStringList &paths, const QString &music_folder)
+{
+    QStringList l_songs;
+    QMap<QString, QStringList> l_folders; // Songs by their folder, sorted by folder
+    for (const QString &l_dropped : paths) {
+        QString l_path = QDir::cleanPath(QDir::fromNativeSeparators(l_dropped));
+        if (!QFileInfo(l_path).isDir()) {
+            if (isAudio(l_path))
+                l_songs.append(relativeName(l_path, music_folder));
+            continue;
+        }
+
+        QString l_folder = relativeName(l_path, music_folder);
+        QDirIterator l_files(l_path, QDir::Files, QDirIterator::Subdirectories);
+        while (l_files.hasNext()) {
+            QString l_file = l_files.next();
+            if (!isAudio(l_file))
+                continue;
+
+            QString l_name = l_folder.isEmpty() ? l_file.mid(l_path.length() + 1) : l_folder + l_file.mid(l_path.length());
+            l_folders[l_name.left(qMax(0, l_name.lastIndexOf('/')))].append(l_name);
+        }
+    }
+
+    // Songs without a folder go first, so they don't get into a category
+    QStringList l_items = l_folders.take(QString()) + l_songs;
+    for (auto l_iter = l_folders.begin(); l_iter != l_folders.end(); ++l_iter) {
+        QString l_category = l_iter.key();
+        l_items.append(l_category.replace('/', " - ").remove('.'));
+        l_iter.value().sort();
+        l_items.append(l_iter.value());
+    }
+
+    return l_items;
+}
+
+QStringList DropScanner::scanFolders(const QStringList &paths, const QString &asset_folder)
+{
+    QStringList l_items;
+    for (const QString &l_dropped : paths) {
+        QString l_path = QDir::cleanPath(QDir::fromNativeSeparators(l_dropped));
+        QFileInfo l_info(l_path);
+        if (!l_info.isDir()) {
+            // A dropped image stands for the folder it's in
+            if (isImage(l_path)) {
+                QString l_name = relativeName(l_info.absolutePath(), asset_folder);
+                if (!l_items.contains(l_name))
+                    l_items.append(l_name);
+            }
+            continue;
+        }
+
+        // Subfolders of an item, e.g. emotions/ or (a)/ of a character, aren't items themselves
+        QStringList l_found;
+        QStringList l_folders(l_path);
+        while (!l_folders.isEmpty()) {
+            QString l_folder = l_folders.takeLast();
+            if (isItemFolder(l_folder)) {
+                l_found.append(relativeName(l_folder, asset_folder));
+                continue;
+            }
+
+            QDirIterator l_dirs(l_folder, QDir::Dirs | QDir::NoDotAndDotDot);
+            while (l_dirs.hasNext())
+                l_folders.append(l_dirs.next());
+        }
+
+        l_found.sort();
+        l_items.append(l_found);
+    }
+
+    return l_items;
+}
+
+bool DropScanner::isAudio(const QString &filename)
+{
+    static const QStringList l_suffixes = {"opus", "ogg", "mp3", "wav", "mid"};
+    return l_suffixes.contains(QFileInfo(filename).suffix().toLower());
+}
+
+bool DropScanner::isImage(const QString &filename)
+{
+    static const QStringList l_suffixes = {"png", "webp", "gif", "apng"};
+    return l_suffixes.contains(QFileInfo(filename).suffix().toLower());
+}
+
+bool DropScanner::isItemFolder(const QString &folder)
+{
+    QDirIterator l_files(folder, QDir::Files);
+    while (l_files.hasNext()) {
+        QString l_file = l_files.next();
+        if (isImage(l_file) || l_files.fileName().compare("char.ini", Qt::CaseInsensitive) == 0)
+            return true;
+    }
+    return false;
+}
+
+QString DropScanner::relativeName(const QString &path, const QString &root)
+{
+    QString l_path = QDir::cleanPath(QDir::fromNativeSeparators(path));
+    QString l_root = QDir::cleanPath(QDir::fromNativeSeparators(root));
+    if (!root.isEmpty() && (l_path == l_root || l_path.startsWith(l_root + "/")))
+        return l_path.mid(l_root.length() + 1);
+
+    return QFileInfo(l_path).fileName();
+}
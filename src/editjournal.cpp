@@ -0,0 +1,255 @@
+#include "include/editjournal.h"
+#include "include/fnvhash.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QHash>
+#include <QStandardPaths>
+
+EditJournal::EditJournal(const QString &filename) :
+    m_file(filename)
+{
+    QDir().mkpath(QFileInfo(filename).absolutePath());
+    m_file.open(QIODevice::WriteOnly | QIODevice::Append);
+}
+
+EditJournal::~EditJournal()
+{
+    flush();
+}
+
+void EditJournal::recordSnapshot(const QString &key, const QVector<int> &ids, const QStringList &names, const QStringList &lengths, bool baseline)
+{
+    QByteArray l_payload;
+    QDataStream l_stream(&l_payload, QIODevice::WriteOnly);
+    l_stream.setVersion(QDataStream::Qt_5_9);
+    l_stream << quint8(baseline ? Baseline : Snapshot) << key << ids << names << lengths;
+    append(l_payload);
+    if (!baseline)
+        m_edits++;
+}
+
+void EditJournal::recordRename(const QString &key, int id, const QString &name)
+{
+    QByteArray l_payload;
+    QDataStream l_stream(&l_payload, QIODevice::WriteOnly);
+    l_stream.setVersion(QDataStream::Qt_5_9);
+    l_stream << quint8(Rename) << key << qint32(id) << name;
+    append(l_payload);
+    m_edits++;
+}
+
+void EditJournal::recordLength(int id, const QString &length)
+{
+    QByteArray l_payload;
+    QDataStream l_stream(&l_payload, QIODevice::WriteOnly);
+    l_stream.setVersion(QDataStream::Qt_5_9);
+    l_stream << quint8(Length) << qint32(id) << length;
+    append(l_payload);
+    m_edits++;
+}
+
+void EditJournal::recordRemove(const QString &key, const QVector<int> &ids)
+{
+    QByteArray l_payload;
+    QDataStream l_stream(&l_payload, QIODevice::WriteOnly);
+    l_stream.setVersion(QDataStream::Qt_5_9);
+    l_stream << quint8(Remove) << key << ids;
+    append(l_payload);
+    m_edits++;
+}
+
+void EditJournal::recordInsert(const QString &key, int after, const QVector<int> &ids, const QStringList &names)
+{
+    QByteArray l_payload;
+    QDataStream l_stream(&l_payload, QIODevice::WriteOnly);
+    l_stream.setVersion(QDataStream::Qt_5_9);
+    l_stream << quint8(Insert) << key << qint32(after) << ids << names;
+    append(l_payload);
+    m_edits++;
+}
+
+void EditJournal::markDirty(const QString &key)
+{
+    m_dirty.insert(key);
+    m_edits++;
+}
+
+int EditJournal::edits() const
+{
+    return m_edits;
+}
+
+qint64 EditJournal::size() const
+{
+    return m_file.size() + m_buffer.size();
+}
+
+QStringList EditJournal::takeDirty()
+{
+    QStringList l_keys = m_dirty.values();
+    m_dirty.clear();
+    return l_keys;
+}
+
+bool EditJournal::flush()
+{
+    if (m_buffer.isEmpty())
+        return true;
+
+    bool l_ok = m_file.write(m_buffer) == m_buffer.size() && m_file.flush();
+    m_buffer.clear();
+    return l_ok;
+}
+
+bool EditJournal::reset()
+{
+    m_buffer.clear();
+    m_dirty.clear();
+    return m_file.resize(0);
+}
+
+void EditJournal::append(const QByteArray &payload)
+{
+    QDataStream l_stream(&m_buffer, QIODevice::WriteOnly | QIODevice::Append);
+    l_stream << quint32(payload.size()) << FnvHash::hash32(payload);
+    l_stream.writeRawData(payload.constData(), payload.size());
+}
+
+int EditJournal::replay(const QString &filename, QMap<QString, JournalConfig> *configs, QStringList *lengths, QSet<QString> *changed)
+{
+    QFile l_file(filename);
+    if (!l_file.open(QIODevice::ReadOnly))
+        return -1;
+
+    QByteArray l_data = l_file.readAll();
+    QHash<QString, QHash<int, int>> l_positions; // Positions of items by id, built when needed
+
+    int l_edits = 0;
+    int l_offset = 0;
+    while (l_offset + 8 <= l_data.size()) {
+        QDataStream l_header(l_data.mid(l_offset, 8));
+        quint32 l_size;
+        quint32 l_checksum;
+        l_header >> l_size >> l_checksum;
+        if (l_size > quint32(l_data.size() - l_offset - 8))
+            break; // Torn by a crash
+
+        QByteArray l_payload = l_data.mid(l_offset + 8, l_size);
+        if (FnvHash::hash32(l_payload) != l_checksum)
+            break;
+        l_offset += 8 + l_size;
+
+        QDataStream l_stream(l_payload);
+        l_stream.setVersion(QDataStream::Qt_5_9);
+        quint8 l_type;
+        QString l_key;
+        l_stream >> l_type;
+        if (l_type == Snapshot || l_type == Baseline) {
+            JournalConfig l_config;
+            QStringList l_lengths;
+            l_stream >> l_key >> l_config.ids >> l_config.names >> l_lengths;
+            if (l_config.ids.size() != l_config.names.size())
+                break;
+
+            configs->insert(l_key, l_config);
+            l_positions.remove(l_key);
+            changed->insert(l_key);
+            for (int i = 0; i < l_lengths.size() && i < l_config.ids.size(); i++) {
+                int l_id = l_config.ids[i];
+                if (l_id <= 0)
+                    continue;
+                while (lengths->size() < l_id)
+                    lengths->append("0");
+                (*lengths)[l_id - 1] = l_lengths[i];
+            }
+        }
+        else if (l_type == Rename) {
+            qint32 l_id;
+            QString l_name;
+            l_stream >> l_key >> l_id >> l_name;
+
+            if (!configs->contains(l_key))
+                continue;
+
+            JournalConfig &l_config = (*configs)[l_key];
+            if (!l_positions.contains(l_key)) {
+                QHash<int, int> &l_ids = l_positions[l_key];
+                for (int i = 0; i < l_config.ids.size(); i++)
+                    l_ids.insert(l_config.ids[i], i);
+            }
+
+            int l_position = l_positions[l_key].value(l_id, -1);
+            if (l_position >= 0) {
+                l_config.names[l_position] = l_name;
+                changed->insert(l_key);
+            }
+        }
+        else if (l_type == Remove || l_type == Insert) {
+            qint32 l_after = 0;
+            QVector<int> l_ids;
+            QStringList l_names;
+            l_stream >> l_key;
+            if (l_type == Insert)
+                l_stream >> l_after;
+            l_stream >> l_ids;
+            if (l_type == Insert)
+                l_stream >> l_names;
+            if (l_type == Insert && l_ids.size() != l_names.size())
+                break;
+            if (!configs->contains(l_key))
+                continue;
+
+            JournalConfig &l_config = (*configs)[l_key];
+            if (l_type == Remove) {
+                QSet<int> l_removed;
+                for (int l_id : qAsConst(l_ids))
+                    l_removed.insert(l_id);
+
+                JournalConfig l_kept;
+                l_kept.ids.reserve(l_config.ids.size());
+                l_kept.names.reserve(l_config.names.size());
+                for (int i = 0; i < l_config.ids.size(); i++) {
+                    if (l_removed.contains(l_config.ids[i]))
+                        continue;
+                    l_kept.ids.append(l_config.ids[i]);
+                    l_kept.names.append(l_config.names[i]);
+                }
+                l_config = l_kept;
+            }
+            else {
+                int l_position = l_after == 0 ? 0 : l_config.ids.indexOf(l_after) + 1;
+                if (l_position == 0 && l_after != 0) // The item they follow is gone, append to the end
+                    l_position = l_config.ids.size();
+                l_config.ids = l_config.ids.mid(0, l_position) + l_ids + l_config.ids.mid(l_position);
+                l_config.names = l_config.names.mid(0, l_position) + l_names + l_config.names.mid(l_position);
+            }
+            l_positions.remove(l_key);
+            changed->insert(l_key);
+        }
+        else if (l_type == Length) {
+            qint32 l_id;
+            QString l_length;
+            l_stream >> l_id >> l_length;
+            if (l_id <= 0)
+                continue;
+            changed->insert("/music.json");
+            while (lengths->size() < l_id)
+                lengths->append("0");
+            (*lengths)[l_id - 1] = l_length;
+        }
+        else
+            break;
+
+        if (l_type != Baseline)
+            l_edits++;
+    }
+
+    return l_edits;
+}
+
+QString EditJournal::location(const QString &config_folder)
+{
+    QByteArray l_hash = QCryptographicHash::hash(QDir::cleanPath(config_folder).toUtf8(), QCryptographicHash::Sha1).toHex();
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/journal/" + QString::fromLatin1(l_hash) + ".journal";
+}
@@ -0,0 +1,123 @@
+#include "include/entrybatch.h"
+#include <QSet>
+#include <algorithm>
+
+QMap<int, QVector<int>> EntryBatch::selectedRows(QTreeWidget *tree)
+{
+    const QModelIndexList l_indexes = tree->selectionModel()->selectedRows();
+
+    QSet<int> l_categories;
+    for (const QModelIndex &l_index : l_indexes)
+        if (!l_index.parent().isValid())
+            l_categories.insert(l_index.row());
+
+    QMap<int, QVector<int>> l_rows;
+    for (const QModelIndex &l_index : l_indexes) {
+        QModelIndex l_parent = l_index.parent();
+        if (!l_parent.isValid())
+            l_rows[-1].append(l_index.row());
+        else if (!l_categories.contains(l_parent.row()))
+            l_rows[l_parent.row()].append(l_index.row());
+    }
+
+    for (QVector<int> &l_group : l_rows)
+        std::sort(l_group.begin(), l_group.end());
+    return l_rows;
+}
+
+QVector<QPair<int, int>> EntryBatch::runs(const QVector<int> &rows)
+{
+    QVector<QPair<int, int>> l_runs;
+    for (int l_row : rows) {
+        if (!l_runs.isEmpty() && l_runs.last().first + l_runs.last().second == l_row)
+            l_runs.last().second++;
+        else
+            l_runs.append(qMakePair(l_row, 1));
+    }
+    return l_runs;
+}
+
+QTreeWidgetItem *EntryBatch::parentItem(QTreeWidget *tree, int parent)
+{
+    return parent < 0 ? tree->invisibleRootItem() : tree->topLevelItem(parent);
+}
+
+void EntryBatch::removeRows(QTreeWidget *tree, int parent, const QVector<int> &rows)
+{
+    // The tree model removes a range of top-level rows at once, but children one at a time
+    QVector<QPair<int, int>> l_runs = runs(rows);
+    if (parent >= 0 || l_runs.size() > MAX_RUNS) {
+        qDeleteAll(takeRows(tree, parent, rows));
+        return;
+    }
+
+    for (int i = l_runs.size() - 1; i >= 0; i--)
+        tree->model()->removeRows(l_runs[i].first, l_runs[i].second);
+}
+
+QList<QTreeWidgetItem *> EntryBatch::takeRows(QTreeWidget *tree, int parent, const QVector<int> &rows)
+{
+    if (rows.isEmpty())
+        return {};
+
+    QTreeWidgetItem *l_parent = parentItem(tree, parent);
+    QList<QTreeWidgetItem *> l_taken;
+    QList<QTreeWidgetItem *> l_kept;
+    l_taken.reserve(rows.size());
+    l_kept.reserve(l_parent->childCount() - rows.size());
+
+    int l_next = 0;
+    for (int i = 0; i < l_parent->childCount(); i++) {
+        if (l_next < rows.size() && rows[l_next] == i) {
+            l_taken.append(l_parent->child(i));
+            l_next++;
+        }
+        else {
+            l_kept.append(l_parent->child(i));
+        }
+    }
+
+    replaceChildren(l_parent, l_kept);
+    return l_taken;
+}
+
+void EntryBatch::insertAfterRows(QTreeWidget *tree, int parent, const QVector<int> &rows, const QList<QTreeWidgetItem *> &items)
+{
+    QTreeWidgetItem *l_parent = parentItem(tree, parent);
+    QVector<QPair<int, int>> l_runs = runs(rows);
+    if (l_runs.size() <= MAX_RUNS) {
+        int l_end = items.size();
+        for (int i = l_runs.size() - 1; i >= 0; i--) {
+            l_end -= l_runs[i].second;
+            l_parent->insertChildren(l_runs[i].first + l_runs[i].second, items.mid(l_end, l_runs[i].second));
+        }
+        return;
+    }
+
+    QList<QTreeWidgetItem *> l_children;
+    l_children.reserve(l_parent->childCount() + items.size());
+    int l_next = 0;
+    for (int i = 0; i < l_parent->childCount(); i++) {
+        l_children.append(l_parent->child(i));
+        for (; l_next < rows.size() && rows[l_next] == i; l_next++)
+            l_children.append(items[l_next]);
+    }
+
+    replaceChildren(l_parent, l_children);
+}
+
+void EntryBatch::replaceChildren(QTreeWidgetItem *parent, const QList<QTreeWidgetItem *> &children)
+{
+    // Expansion belongs to the view, so it's lost when the items leave the tree
+    QSet<QTreeWidgetItem *> l_expanded;
+    for (int i = 0; i < parent->childCount(); i++)
+        if (parent->child(i)->isExpanded())
+            l_expanded.insert(parent->child(i));
+
+    parent->takeChildren();
+    parent->addChildren(children);
+
+    for (QTreeWidgetItem *l_item : children)
+        if (l_expanded.contains(l_item))
+            l_item->setExpanded(true);
+}
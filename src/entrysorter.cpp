@@ -0,0 +1,108 @@
+#include "include/entrysorter.h"
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <algorithm>
+
+namespace {
+struct Range
+{
+    int begin;
+    int middle;
+    int end;
+};
+}
+
+QVector<SortKey> EntrySorter::nameKeys(const QStringList &names)
+{
+    QVector<SortKey> l_keys(names.size());
+    SortKey *l_data = l_keys.data();
+
+    QVector<int> l_chunks;
+    for (int i = 0; i < names.size(); i += CHUNK_SIZE)
+        l_chunks.append(i);
+
+    QtConcurrent::blockingMap(l_chunks, [&names, l_data](int begin) {
+        int l_end = qMin(begin + CHUNK_SIZE, names.size());
+        for (int i = begin; i < l_end; i++)
+            l_data[i].text = naturalKey(names[i]);
+    });
+
+    return l_keys;
+}
+
+QString EntrySorter::naturalKey(const QString &name)
+{
+    QString l_folded = name.toCaseFolded();
+    QString l_key;
+    l_key.reserve(l_folded.size() + NUMBER_WIDTH);
+    for (int i = 0; i < l_folded.size();) {
+        if (!l_folded[i].isDigit()) {
+            l_key += l_folded[i++];
+            continue;
+        }
+
+        int l_begin = i;
+        while (i < l_folded.size() && l_folded[i].isDigit())
+            i++;
+
+        // Leading zeros don't change the value, padding makes longer numbers compare greater
+        int l_first = l_begin;
+        while (l_first < i - 1 && l_folded[l_first] == '0')
+            l_first++;
+        int l_length = i - l_first;
+        if (l_length < NUMBER_WIDTH)
+            l_key += QString(NUMBER_WIDTH - l_length, '0');
+        l_key += l_folded.mid(l_first, l_length);
+    }
+
+    return l_key;
+}
+
+QVector<int> EntrySorter::order(const QVector<SortKey> &keys, bool descending)
+{
+    auto l_less = [&keys, descending](int a, int b) {
+        const SortKey &l_a = keys[a];
+        const SortKey &l_b = keys[b];
+        if (l_a.missing != l_b.missing)
+            return l_b.missing;
+        if (descending)
+            return l_b.number < l_a.number || (l_b.number == l_a.number && l_b.text < l_a.text);
+        return l_a.number < l_b.number || (l_a.number == l_b.number && l_a.text < l_b.text);
+    };
+
+    QVector<int> l_order(keys.size());
+    for (int i = 0; i < l_order.size(); i++)
+        l_order[i] = i;
+
+    int l_chunk = qMax(CHUNK_SIZE, keys.size() / qMax(1, QThreadPool::globalInstance()->maxThreadCount()) + 1);
+    QVector<Range> l_ranges;
+    for (int i = 0; i < l_order.size(); i += l_chunk)
+        l_ranges.append(Range{i, i, qMin(i + l_chunk, l_order.size())});
+
+    int *l_data = l_order.data();
+    QtConcurrent::blockingMap(l_ranges, [l_data, &l_less](Range &range) {
+        std::stable_sort(l_data + range.begin, l_data + range.end, l_less);
+    });
+
+    // Merge neighbouring ranges until one is left, the left range wins ties
+    QVector<int> l_buffer(l_order.size());
+    while (l_ranges.size() > 1) {
+        QVector<Range> l_merges;
+        for (int i = 0; i < l_ranges.size(); i += 2)
+            if (i + 1 < l_ranges.size())
+                l_merges.append(Range{l_ranges[i].begin, l_ranges[i].end, l_ranges[i + 1].end});
+            else
+                l_merges.append(Range{l_ranges[i].begin, l_ranges[i].end, l_ranges[i].end});
+
+        const int *l_source = l_order.constData();
+        int *l_target = l_buffer.data();
+        QtConcurrent::blockingMap(l_merges, [l_source, l_target, &l_less](Range &range) {
+            std::merge(l_source + range.begin, l_source + range.middle, l_source + range.middle, l_source + range.end, l_target + range.begin, l_less);
+        });
+
+        l_order.swap(l_buffer);
+        l_ranges = l_merges;
+    }
+
+    return l_order;
+}
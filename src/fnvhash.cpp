@@ -0,0 +1,24 @@
+#include "include/fnvhash.h"
+
+quint32 FnvHash::hash32(const QByteArray &data)
+{
+    quint32 l_hash = 2166136261u;
+    for (char l_byte : data) {
+        l_hash ^= quint8(l_byte);
+        l_hash *= 16777619u;
+    }
+
+    return l_hash;
+}
+
+quint64 FnvHash::hash64(const QString &text)
+{
+    quint64 l_hash = 14695981039346656037ULL;
+    const QChar *l_data = text.constData();
+    for (int i = 0; i < text.size(); i++) {
+        l_hash ^= l_data[i].unicode();
+        l_hash *= 1099511628211ULL;
+    }
+
+    return l_hash;
+}
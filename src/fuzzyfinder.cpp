@@ -0,0 +1,178 @@
+#include "include/fuzzyfinder.h"
+#include <QtAlgorithms>
+#include <QtConcurrent>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AACE_SSE2
+#endif
+
+namespace {
+/**
+ * @brief Find the character in data[from, size), 8 characters at once with SSE2.
+ */
+int findChar(const ushort *data, int from, int size, ushort c)
+{
+    int i = from;
+#ifdef AACE_SSE2
+    const __m128i l_needle = _mm_set1_epi16(short(c));
+    for (; i + 8 <= size; i += 8) {
+        __m128i l_chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        int l_found = _mm_movemask_epi8(_mm_cmpeq_epi16(l_chunk, l_needle));
+        if (l_found != 0)
+            return i + int(qCountTrailingZeroBits(quint32(l_found))) / 2;
+    }
+#endif
+    for (; i < size; i++)
+        if (data[i] == c)
+            return i;
+
+    return -1;
+}
+
+bool isSeparator(ushort c)
+{
+    return c == '/' || c == ' ' || c == '_' || c == '-' || c == '.' || c == '(' || c == '[';
+}
+
+bool betterMatch(const FuzzyMatch &a, const FuzzyMatch &b)
+{
+    return a.score != b.score ? a.score > b.score : a.index < b.index;
+}
+}
+
+void FuzzyFinder::setEntries(const QVector<FinderEntry> &entries)
+{
+    m_entries = entries;
+    m_offsets.resize(entries.size() + 1);
+    m_masks.resize(entries.size());
+    m_folded.clear();
+
+    int l_size = 0;
+    for (const FinderEntry &l_entry : entries)
+        l_size += l_entry.name.size();
+    m_folded.reserve(l_size);
+
+    for (int i = 0; i < entries.size(); i++) {
+        m_offsets[i] = m_folded.size();
+        quint64 l_mask = 0;
+        const QString &l_name = entries[i].name;
+        for (int j = 0; j < l_name.size(); j++) {
+            ushort l_char = l_name[j].toLower().unicode();
+            m_folded.append(l_char);
+            l_mask |= mask(l_char);
+        }
+        m_masks[i] = l_mask;
+    }
+    m_offsets[entries.size()] = m_folded.size();
+}
+
+QVector<FuzzyMatch> FuzzyFinder::find(const QString &query, int limit) const
+{
+    QVector<ushort> l_query;
+    quint64 l_query_mask = 0;
+    for (int i = 0; i < query.size() && l_query.size() < MAX_QUERY; i++) {
+        if (query[i].isSpace())
+            continue;
+
+        ushort l_char = query[i].toLower().unicode();
+        l_query.append(l_char);
+        l_query_mask |= mask(l_char);
+    }
+
+    if (l_query.isEmpty() || limit <= 0)
+        return QVector<FuzzyMatch>();
+
+    // Best matches of each chunk, scored in parallel
+    struct Chunk
+    {
+        int begin;
+        int end;
+        QVector<FuzzyMatch> matches;
+    };
+
+    QVector<Chunk> l_chunks;
+    for (int i = 0; i < m_entries.size(); i += CHUNK_SIZE)
+        l_chunks.append(Chunk{i, qMin(i + CHUNK_SIZE, m_entries.size()), QVector<FuzzyMatch>()});
+
+    const ushort *l_query_data = l_query.constData();
+    const int l_query_size = l_query.size();
+    QtConcurrent::blockingMap(l_chunks, [this, l_query_data, l_query_size, l_query_mask, limit](Chunk &chunk) {
+        for (int i = chunk.begin; i < chunk.end; i++) {
+            int l_score = score(i, l_query_data, l_query_size, l_query_mask);
+            if (l_score >= 0)
+                chunk.matches.append(FuzzyMatch{i, l_score});
+        }
+
+        if (chunk.matches.size() > limit) {
+            std::partial_sort(chunk.matches.begin(), chunk.matches.begin() + limit, chunk.matches.end(), betterMatch);
+            chunk.matches.resize(limit);
+        }
+    });
+
+    QVector<FuzzyMatch> l_matches;
+    for (const Chunk &l_chunk : qAsConst(l_chunks))
+        l_matches += l_chunk.matches;
+
+    int l_count = qMin(limit, l_matches.size());
+    std::partial_sort(l_matches.begin(), l_matches.begin() + l_count, l_matches.end(), betterMatch);
+    l_matches.resize(l_count);
+    return l_matches;
+}
+
+const FinderEntry &FuzzyFinder::entry(int index) const
+{
+    return m_entries[index];
+}
+
+int FuzzyFinder::count() const
+{
+    return m_entries.size();
+}
+
+int FuzzyFinder::score(int index, const ushort *query, int query_size, quint64 query_mask) const
+{
+    if ((m_masks[index] & query_mask) != query_mask)
+        return -1;
+
+    const ushort *l_name = m_folded.constData() + m_offsets[index];
+    const int l_size = m_offsets[index + 1] - m_offsets[index];
+
+    // Leftmost subsequence
+    int l_pos = 0;
+    int l_last = -1;
+    for (int k = 0; k < query_size; k++) {
+        l_last = findChar(l_name, l_pos, l_size, query[k]);
+        if (l_last < 0)
+            return -1;
+        l_pos = l_last + 1;
+    }
+
+    // Tighten it backwards from its end
+    int l_positions[MAX_QUERY];
+    l_pos = l_last;
+    for (int k = query_size - 1; k >= 0; k--) {
+        while (l_name[l_pos] != query[k])
+            l_pos--;
+        l_positions[k] = l_pos--;
+    }
+
+    int l_score = 1000 - l_size;
+    for (int k = 0; k < query_size; k++) {
+        int l_at = l_positions[k];
+        if (l_at == 0 || isSeparator(l_name[l_at - 1]))
+            l_score += 30;
+        if (k > 0) {
+            int l_gap = l_at - l_positions[k - 1] - 1;
+            l_score += l_gap == 0 ? 20 : -qMin(l_gap, 20);
+        }
+    }
+
+    return qMax(l_score, 0);
+}
+
+quint64 FuzzyFinder::mask(ushort c)
+{
+    return quint64(1) << (c < 128 ? c & 63 : 63);
+}
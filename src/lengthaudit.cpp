@@ -0,0 +1,73 @@
+#include "include/lengthaudit.h"
+#include "include/lengthprober.h"
+#include <QDateTime>
+#include <QFileInfo>
+#include <QHash>
+#include <QtConcurrent>
+
+QVector<LengthCheck> LengthAudit::audit(const QString &music_folder, const QVector<LengthCheck> &songs, DurationCache *cache, double tolerance)
+{
+    struct File
+    {
+        QString path;
+        bool exists;
+        double length;
+    };
+
+    // Songs listed several times are probed once
+    QVector<File> l_files;
+    QHash<QString, int> l_indexes;
+    QVector<int> l_song_files(songs.size(), -1);
+    for (int i = 0; i < songs.size(); i++) {
+        if (songs[i].name.contains("://"))
+            continue;
+
+        int l_index = l_indexes.value(songs[i].name, -1);
+        if (l_index < 0) {
+            l_index = l_files.size();
+            l_indexes.insert(songs[i].name, l_index);
+            l_files.append(File{music_folder + "/" + songs[i].name, false, 0});
+        }
+        l_song_files[i] = l_index;
+    }
+
+    QtConcurrent::blockingMap(l_files, [cache](File &file) {
+        QFileInfo l_file(file.path);
+        file.exists = l_file.isFile();
+        if (!file.exists)
+            return;
+
+        qint64 l_modified = l_file.lastModified().toMSecsSinceEpoch();
+        if (!cache->find(file.path, l_file.size(), l_modified, &file.length)) {
+            file.length = LengthProber::length(file.path);
+            if (file.length > 0)
+                cache->insert(file.path, l_file.size(), l_modified, file.length);
+        }
+    });
+
+    QVector<LengthCheck> l_problems;
+    for (int i = 0; i < songs.size(); i++) {
+        if (l_song_files[i] < 0)
+            continue;
+
+        const File &l_file = l_files[l_song_files[i]];
+        LengthCheck l_check = songs[i];
+        l_check.actual = l_file.length;
+
+        bool l_ok;
+        double l_stored = l_check.stored.toDouble(&l_ok);
+        if (!l_file.exists)
+            l_check.problem = LengthCheck::Missing;
+        else if (!l_ok || l_stored <= 0)
+            l_check.problem = LengthCheck::Zero;
+        else if (l_file.length <= 0)
+            l_check.problem = LengthCheck::Unreadable;
+        else if (qAbs(l_stored - l_file.length) > tolerance)
+            l_check.problem = LengthCheck::Differs;
+
+        if (l_check.problem != LengthCheck::None)
+            l_problems.append(l_check);
+    }
+
+    return l_problems;
+}
@@ -0,0 +1,90 @@
+#include "include/lengthauditdialog.h"
+#include <QDialogButtonBox>
+#include <QHeaderView>
+#include <QPushButton>
+#include <QVBoxLayout>
+
+LengthAuditDialog::LengthAuditDialog(const QVector<LengthCheck> &checks, int total, qint64 elapsed, QWidget *parent) :
+    QDialog(parent),
+    m_checks(checks),
+    m_total(total),
+    m_elapsed(elapsed)
+{
+    setWindowTitle(tr("Song lengths"));
+    resize(700, 500);
+
+    m_summary = new QLabel(this);
+    m_list = new QTreeWidget(this);
+    m_list->setColumnCount(5);
+    m_list->setHeaderLabels({tr("Id"), tr("Song"), tr("Stored"), tr("Actual"), tr("Problem")});
+    m_list->header()->setSectionResizeMode(1, QHeaderView::Stretch);
+    m_list->header()->setStretchLastSection(false);
+    m_list->setRootIsDecorated(false);
+    m_list->setUniformRowHeights(true);
+
+    bool l_fixable = false;
+    QList<QTreeWidgetItem *> l_items;
+    l_items.reserve(m_checks.size());
+    for (int i = 0; i < m_checks.size(); i++) {
+        const LengthCheck &l_check = m_checks[i];
+        QString l_actual = l_check.actual > 0 ? QString::number(l_check.actual, 'f', 3) : QString();
+        QTreeWidgetItem *l_item = new QTreeWidgetItem(QStringList{QString::number(l_check.id), l_check.name, l_check.stored, l_actual, describe(l_check)});
+        if (l_check.isFixable()) {
+            l_item->setFlags(l_item->flags() | Qt::ItemIsUserCheckable);
+            l_item->setCheckState(0, Qt::Checked);
+            l_fixable = true;
+        }
+        l_item->setData(0, Qt::UserRole, i);
+        l_item->setTextAlignment(2, Qt::AlignRight | Qt::AlignVCenter);
+        l_item->setTextAlignment(3, Qt::AlignRight | Qt::AlignVCenter);
+        l_items.append(l_item);
+    }
+    m_list->addTopLevelItems(l_items);
+    connect(m_list, &QTreeWidget::itemChanged, this, &LengthAuditDialog::updateSummary);
+
+    QDialogButtonBox *l_buttons = new QDialogButtonBox(QDialogButtonBox::Close, this);
+    QPushButton *l_fix_button = l_buttons->addButton(tr("Fix lengths"), QDialogButtonBox::AcceptRole);
+    l_fix_button->setEnabled(l_fixable);
+    connect(l_buttons, &QDialogButtonBox::accepted, this, &QDialog::accept);
+    connect(l_buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+
+    QVBoxLayout *l_layout = new QVBoxLayout(this);
+    l_layout->addWidget(m_summary);
+    l_layout->addWidget(m_list);
+    l_layout->addWidget(l_buttons);
+
+    updateSummary();
+}
+
+QVector<LengthCheck> LengthAuditDialog::checkedSongs() const
+{
+    QVector<LengthCheck> l_checks;
+    for (int i = 0; i < m_list->topLevelItemCount(); i++) {
+        QTreeWidgetItem *l_item = m_list->topLevelItem(i);
+        const LengthCheck &l_check = m_checks[l_item->data(0, Qt::UserRole).toInt()];
+        if (l_check.isFixable() && l_item->checkState(0) == Qt::Checked)
+            l_checks.append(l_check);
+    }
+    return l_checks;
+}
+
+QString LengthAuditDialog::describe(const LengthCheck &check)
+{
+    switch (check.problem) {
+    case LengthCheck::Differs:
+        return tr("Off by %1 s").arg(QString::number(check.actual - check.stored.toDouble(), 'f', 3));
+    case LengthCheck::Zero:
+        return tr("No length");
+    case LengthCheck::Missing:
+        return tr("Missing file");
+    case LengthCheck::Unreadable:
+        return tr("Can't decode");
+    default:
+        return QString();
+    }
+}
+
+void LengthAuditDialog::updateSummary()
+{
+    m_summary->setText(tr("%1 of %2 songs have wrong lengths or files, audited in %3 ms. %4 lengths are checked to be fixed.").arg(m_checks.size()).arg(m_total).arg(m_elapsed).arg(checkedSongs().size()));
+}
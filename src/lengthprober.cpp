@@ -0,0 +1,84 @@
+#include "include/lengthprober.h"
+#include "include/bassmidi.h"
+#include "include/bassopus.h"
+#include "include/midifile.h"
+#include <QDateTime>
+#include <QFileInfo>
+#include <QtConcurrent>
+
+LengthProber::LengthProber(DurationCache *cache, QObject *parent) :
+    QObject(parent),
+    m_cache(cache)
+{
+}
+
+LengthProber::~LengthProber()
+{
+    cancel();
+}
+
+void LengthProber::probe(const QString &path)
+{
+    m_pending.ref();
+    QtConcurrent::run(&m_pool, [this, path] {
+        QFileInfo l_file(path);
+        qint64 l_size = l_file.size();
+        qint64 l_modified = l_file.lastModified().toMSecsSinceEpoch();
+
+        double l_length;
+        if (!m_cache->find(path, l_size, l_modified, &l_length)) {
+            l_length = length(path);
+            if (l_length > 0)
+                m_cache->insert(path, l_size, l_modified, l_length);
+        }
+
+        m_pending.deref();
+        emit lengthProbed(path, l_length);
+    });
+}
+
+int LengthProber::pending() const
+{
+    return m_pending.loadAcquire();
+}
+
+void LengthProber::cancel()
+{
+    m_pool.clear();
+    m_pool.waitForDone();
+    m_pending.storeRelease(0);
+}
+
+bool LengthProber::initDecoder()
+{
+    static const bool l_ready = BASS_Init(0, 48000, 0, 0, 0) || BASS_ErrorGetCode() == BASS_ERROR_ALREADY;
+    return l_ready;
+}
+
+double LengthProber::length(const QString &path)
+{
+    if (MidiFile::isMidi(path)) // BASSMIDI would load soundfonts just to get the length
+        return MidiFile::length(path);
+
+    HSTREAM l_stream = openDecoder(path);
+    if (l_stream == 0)
+        return 0;
+
+    double l_length = BASS_ChannelBytes2Seconds(l_stream, BASS_ChannelGetLength(l_stream, BASS_POS_BYTE));
+    BASS_StreamFree(l_stream);
+    return qMax(l_length, 0.0);
+}
+
+HSTREAM LengthProber::openDecoder(const QString &path, DWORD flags)
+{
+    if (!initDecoder())
+        return 0;
+
+    BASS_SetDevice(0);
+    flags |= BASS_UNICODE | BASS_STREAM_DECODE;
+    if (path.endsWith(".opus", Qt::CaseInsensitive))
+        return BASS_OPUS_StreamCreateFile(FALSE, path.utf16(), 0, 0, flags);
+    if (MidiFile::isMidi(path))
+        return BASS_MIDI_StreamCreateFile(FALSE, path.utf16(), 0, 0, flags, 1);
+    return BASS_StreamCreateFile(FALSE, path.utf16(), 0, 0, flags);
+}
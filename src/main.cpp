@@ -5,6 +5,8 @@
 int main(int argc, char *argv[])
 {
     QApplication app(argc, argv);
+    app.setOrganizationName("Ddedinya");
+    app.setApplicationName("AkashiAssetConfigEditor");
     Program Program;
     Program.show();
     return app.exec();
@@ -0,0 +1,221 @@
+#include "include/midifile.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QVector>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+/**
+ * @brief Tempo change in microseconds per quarter note.
+ */
+struct TempoEvent
+{
+    quint64 tick;
+    quint32 tempo;
+};
+
+quint32 readBig(const uchar *data, int size)
+{
+    quint32 l_value = 0;
+    for (int i = 0; i < size; i++)
+        l_value = (l_value << 8) | data[i];
+    return l_value;
+}
+
+/**
+ * @brief Read a variable length quantity, false if it runs past the end.
+ */
+bool readVarLen(const uchar *&pos, const uchar *end, quint32 *value)
+{
+    quint32 l_value = 0;
+    for (int i = 0; i < 4; i++) {
+        if (pos >= end)
+            return false;
+        uchar l_byte = *pos++;
+        l_value = (l_value << 7) | (l_byte & 0x7F);
+        if ((l_byte & 0x80) == 0) {
+            *value = l_value;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Read all events of the track, collecting its tempo changes.
+ *
+ * @return Tick of the last event, including the end of track.
+ */
+bool readTrack(const uchar *pos, const uchar *end, QVector<TempoEvent> *tempos, quint64 *last_tick)
+{
+    quint64 l_tick = 0;
+    uchar l_status = 0;
+    while (pos < end) {
+        quint32 l_delta;
+        if (!readVarLen(pos, end, &l_delta) || pos >= end)
+            return false;
+        l_tick += l_delta;
+
+        uchar l_byte = *pos;
+        if (l_byte & 0x80) {
+            l_status = l_byte;
+            pos++;
+        }
+        else if (l_status == 0 || l_status >= 0xF0) { // Running status is only for channel messages
+            return false;
+        }
+
+        if (l_status == 0xFF) {
+            if (pos >= end)
+                return false;
+            uchar l_type = *pos++;
+            quint32 l_length;
+            if (!readVarLen(pos, end, &l_length) || l_length > quint32(end - pos))
+                return false;
+            if (l_type == 0x51 && l_length == 3)
+                tempos->append(TempoEvent{l_tick, readBig(pos, 3)});
+            pos += l_length;
+            l_status = 0;
+            if (l_type == 0x2F) // End of track
+                break;
+        }
+        else if (l_status == 0xF0 || l_status == 0xF7) {
+            quint32 l_length;
+            if (!readVarLen(pos, end, &l_length) || l_length > quint32(end - pos))
+                return false;
+            pos += l_length;
+            l_status = 0;
+        }
+        else {
+            int l_size = (l_status & 0xF0) == 0xC0 || (l_status & 0xF0) == 0xD0 ? 1 : 2;
+            if (l_size > end - pos)
+                return false;
+            pos += l_size;
+        }
+    }
+
+    *last_tick = l_tick;
+    return true;
+}
+
+/**
+ * @brief Convert ticks to seconds with the tempo map sorted by ticks.
+ */
+double tickSeconds(quint64 tick, const QVector<TempoEvent> &tempos, quint32 default_tempo, double ticks_per_quarter)
+{
+    double l_seconds = 0;
+    quint64 l_from = 0;
+    quint32 l_tempo = default_tempo;
+    for (const TempoEvent &l_event : tempos) {
+        if (l_event.tick >= tick)
+            break;
+        l_seconds += (l_event.tick - l_from) * l_tempo / 1e6 / ticks_per_quarter;
+        l_from = l_event.tick;
+        l_tempo = l_event.tempo;
+    }
+    return l_seconds + (tick - l_from) * l_tempo / 1e6 / ticks_per_quarter;
+}
+}
+
+bool MidiFile::isMidi(const QString &path)
+{
+    QString l_suffix = QFileInfo(path).suffix().toLower();
+    return l_suffix == "mid" || l_suffix == "midi" || l_suffix == "rmi";
+}
+
+double MidiFile::length(const QString &path, bool *ok)
+{
+    QFile l_file(path);
+    if (!l_file.open(QIODevice::ReadOnly)) {
+        if (ok != nullptr)
+            *ok = false;
+        return 0;
+    }
+
+    return length(l_file.readAll(), ok);
+}
+
+double MidiFile::length(const QByteArray &data, bool *ok)
+{
+    if (ok != nullptr)
+        *ok = false;
+
+    const uchar *l_begin = reinterpret_cast<const uchar *>(data.constData());
+    const uchar *l_end = l_begin + data.size();
+
+    // RIFF MIDI keeps the standard file in its "data" chunk
+    if (data.startsWith("RIFF") && data.mid(8, 4) == "RMID") {
+        const uchar *l_pos = l_begin + 12;
+        while (l_end - l_pos >= 8 && memcmp(l_pos, "data", 4) != 0) {
+            quint32 l_length = quint32(l_pos[4]) | quint32(l_pos[5]) << 8 | quint32(l_pos[6]) << 16 | quint32(l_pos[7]) << 24;
+            if (l_length > quint32(l_end - l_pos - 8))
+                return 0;
+            l_pos += 8 + l_length + (l_length & 1); // Chunks are padded to even sizes
+        }
+        if (l_end - l_pos < 8)
+            return 0;
+        l_begin = l_pos + 8;
+    }
+
+    if (l_end - l_begin < 14 || memcmp(l_begin, "MThd", 4) != 0)
+        return 0;
+
+    quint32 l_header_length = readBig(l_begin + 4, 4);
+    int l_format = readBig(l_begin + 8, 2);
+    int l_tracks = readBig(l_begin + 10, 2);
+    quint32 l_division = readBig(l_begin + 12, 2);
+    if (l_header_length < 6 || l_header_length > quint32(l_end - l_begin - 8) || l_division == 0)
+        return 0;
+
+    // SMPTE divisions count ticks per frame instead of per quarter note, tempo doesn't matter then
+    double l_ticks_per_quarter = l_division;
+    quint32 l_default_tempo = DEFAULT_TEMPO;
+    bool l_smpte = l_division & 0x8000;
+    if (l_smpte) {
+        int l_fps = -qint8(l_division >> 8);
+        double l_frames = l_fps == 29 ? 29.97 : l_fps;
+        l_ticks_per_quarter = l_frames * (l_division & 0xFF);
+        l_default_tempo = 1000000;
+        if (l_ticks_per_quarter <= 0)
+            return 0;
+    }
+
+    QVector<TempoEvent> l_tempos;
+    quint64 l_last_tick = 0;
+    double l_sequential = 0; // Tracks of format 2 are independent songs played one after another
+    const uchar *l_pos = l_begin + 8 + l_header_length;
+    for (int i = 0; i < l_tracks && l_end - l_pos >= 8; i++) {
+        quint32 l_length = readBig(l_pos + 4, 4);
+        const uchar *l_data = l_pos + 8;
+        if (l_length > quint32(l_end - l_data))
+            return 0;
+        l_pos = l_data + l_length;
+        if (memcmp(l_data - 8, "MTrk", 4) != 0) { // Unknown chunks are skipped
+            i--;
+            continue;
+        }
+
+        QVector<TempoEvent> l_track_tempos;
+        quint64 l_track_tick;
+        if (!readTrack(l_data, l_data + l_length, &l_track_tempos, &l_track_tick))
+            return 0;
+
+        if (l_format == 2) {
+            l_sequential += tickSeconds(l_track_tick, l_smpte ? QVector<TempoEvent>() : l_track_tempos, l_default_tempo, l_ticks_per_quarter);
+            continue;
+        }
+
+        if (!l_smpte)
+            l_tempos += l_track_tempos;
+        l_last_tick = qMax(l_last_tick, l_track_tick);
+    }
+
+    if (ok != nullptr)
+        *ok = true;
+    if (l_format == 2)
+        return l_sequential;
+
+    std::stable_sort(l_tempos.begin(), l_tempos.end(), [](const TempoEvent &a, const TempoEvent &b) { return a.tick < b.tick; });
+    return tickSeconds(l_last_tick, l_tempos, l_default_tempo, l_ticks_per_quarter);
+}
@@ -0,0 +1,158 @@
+#include "include/opustranscoder.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QThread>
+#include <QTimer>
+
+const char *OpusTranscoder::DEFAULT_COMMAND = "ffmpeg -nostdin -y -loglevel error -i {input} -vn -c:a libopus -b:a 96k -f opus {output}";
+
+OpusTranscoder::OpusTranscoder(QObject *parent) :
+    QObject(parent),
+    m_max_processes(qMax(QThread::idealThreadCount(), 1))
+{
+    setCommand(DEFAULT_COMMAND);
+}
+
+OpusTranscoder::~OpusTranscoder()
+{
+    cancel();
+}
+
+bool OpusTranscoder::setCommand(const QString &command)
+{
+    QStringList l_command = splitCommand(command);
+    if (l_command.size() < 2 || !l_command.contains("{input}") || !l_command.contains("{output}"))
+        return false;
+
+    m_command = l_command;
+    return true;
+}
+
+void OpusTranscoder::setMaxProcesses(int count)
+{
+    m_max_processes = qMax(count, 1);
+}
+
+void OpusTranscoder::start(const QVector<TranscodeJob> &jobs)
+{
+    // Two encoders writing one partial file would rename a corrupted song into place
+    QSet<QString> l_targets;
+    for (const TranscodeJob &l_job : qAsConst(m_queue))
+        l_targets.insert(l_job.target.toLower());
+    for (const QProcess *l_process : qAsConst(m_processes))
+        l_targets.insert(l_process->property("target").toString().toLower());
+
+    for (const TranscodeJob &l_job : jobs) {
+        QString l_target = l_job.target.toLower(); // Case-insensitive file systems
+        if (l_targets.contains(l_target))
+            continue;
+        l_targets.insert(l_target);
+        m_queue.enqueue(l_job);
+    }
+    startNext();
+}
+
+void OpusTranscoder::cancel()
+{
+    m_queue.clear();
+    const QList<QProcess *> l_processes = m_processes;
+    m_processes.clear();
+    for (QProcess *l_process : l_processes) {
+        l_process->disconnect(this);
+        l_process->kill();
+        l_process->waitForFinished(1000);
+        QFile::remove(l_process->property("partial").toString());
+        delete l_process;
+    }
+}
+
+bool OpusTranscoder::isRunning() const
+{
+    return !m_processes.isEmpty() || !m_queue.isEmpty();
+}
+
+QStringList OpusTranscoder::splitCommand(const QString &command)
+{
+    QStringList l_parts;
+    QString l_part;
+    bool l_quoted = false;
+    bool l_started = false;
+    for (QChar l_char : command) {
+        if (l_char == '"') {
+            l_quoted = !l_quoted;
+            l_started = true;
+        }
+        else if (l_char.isSpace() && !l_quoted) {
+            if (l_started)
+                l_parts.append(l_part);
+            l_part.clear();
+            l_started = false;
+        }
+        else {
+            l_part += l_char;
+            l_started = true;
+        }
+    }
+    if (l_started)
+        l_parts.append(l_part);
+    return l_parts;
+}
+
+void OpusTranscoder::startNext()
+{
+    while (m_processes.size() < m_max_processes && !m_queue.isEmpty()) {
+        TranscodeJob l_job = m_queue.dequeue();
+        QString l_partial = partialFile(l_job.target);
+        QStringList l_arguments = m_command.mid(1);
+        l_arguments.replaceInStrings("{input}", l_job.source);
+        l_arguments.replaceInStrings("{output}", l_partial);
+
+        QProcess *l_process = new QProcess(this);
+        l_process->setProperty("partial", l_partial);
+        l_process->setProperty("target", l_job.target);
+        l_process->setProcessChannelMode(QProcess::MergedChannels);
+        l_process->setStandardInputFile(QProcess::nullDevice());
+        connect(l_process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, [this, l_process, l_job](int exit_code, QProcess::ExitStatus status) { processFinished(l_process, l_job, exit_code, status); });
+        connect(l_process, &QProcess::errorOccurred, this, [this, l_process, l_job](QProcess::ProcessError error) {
+            // No finished signal follows, and on Windows the error arrives inside start(), so startNext() isn't reentered
+            if (error == QProcess::FailedToStart)
+                QTimer::singleShot(0, l_process, [this, l_process, l_job] { processFinished(l_process, l_job, -1, QProcess::CrashExit); });
+        });
+        m_processes.append(l_process);
+        l_process->start(m_command.first(), l_arguments);
+    }
+
+    if (m_processes.isEmpty())
+        emit finished();
+}
+
+void OpusTranscoder::processFinished(QProcess *process, const TranscodeJob &job, int exit_code, QProcess::ExitStatus status)
+{
+    if (!m_processes.removeOne(process))
+        return;
+
+    TranscodeResult l_result;
+    l_result.job = job;
+    l_result.source_size = QFileInfo(job.source).size();
+    QString l_partial = partialFile(job.target);
+    if (status == QProcess::NormalExit && exit_code == 0 && QFileInfo(l_partial).size() > 0) {
+        l_result.ok = !QFile::exists(job.target) && QFile::rename(l_partial, job.target);
+        l_result.error = l_result.ok ? QString() : tr("Can't create %1").arg(job.target);
+        l_result.target_size = QFileInfo(job.target).size();
+    }
+    else {
+        QStringList l_output = QString::fromLocal8Bit(process->readAll()).trimmed().split('\n');
+        l_result.error = process->error() == QProcess::FailedToStart ? tr("Can't start %1").arg(m_command.first()) : l_output.last().trimmed();
+    }
+    QFile::remove(l_partial);
+    process->deleteLater();
+
+    emit songFinished(l_result);
+    startNext();
+}
+
+QString OpusTranscoder::partialFile(const QString &target)
+{
+    QFileInfo l_target(target);
+    return l_target.path() + "/." + l_target.completeBaseName() + ".part.opus";
+}
@@ -0,0 +1,58 @@
+#include "include/patterncache.h"
+
+PatternCache::PatternCache(int capacity)
+{
+    m_patterns.setMaxCost(capacity);
+}
+
+QRegularExpression PatternCache::pattern(const QString &text, Syntax syntax)
+{
+    QString l_key = (syntax == Glob ? "g:" : "r:") + text;
+    QRegularExpression *l_pattern = m_patterns.object(l_key);
+    if (l_pattern != nullptr)
+        return *l_pattern;
+
+    if (syntax == Glob)
+        l_pattern = new QRegularExpression(globToRegex(text), QRegularExpression::CaseInsensitiveOption);
+    else
+        l_pattern = new QRegularExpression(text, QRegularExpression::CaseInsensitiveOption);
+
+    if (l_pattern->isValid())
+        l_pattern->optimize();
+
+    QRegularExpression l_result = *l_pattern;
+    m_patterns.insert(l_key, l_pattern);
+    return l_result;
+}
+
+QString PatternCache::globToRegex(const QString &glob)
+{
+    QString l_regex;
+    l_regex.reserve(glob.size() * 2 + 4);
+    l_regex += "\\A(?:";
+    for (int i = 0; i < glob.size(); i++) {
+        QChar l_char = glob[i];
+        if (l_char == '*')
+            l_regex += ".*";
+        else if (l_char == '?')
+            l_regex += '.';
+        else if (l_char == '[') {
+            int l_end = glob.indexOf(']', i + 2);
+            if (l_end < 0) {
+                l_regex += "\\[";
+                continue;
+            }
+
+            QString l_class = glob.mid(i + 1, l_end - i - 1);
+            if (l_class.startsWith('!'))
+                l_class[0] = '^';
+            l_regex += '[' + l_class.replace("\\", "\\\\") + ']';
+            i = l_end;
+        }
+        else
+            l_regex += QRegularExpression::escape(QString(l_char));
+    }
+    l_regex += ")\\z";
+
+    return l_regex;
+}
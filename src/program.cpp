@@ -1,37 +1,123 @@
 #include "include/program.h"
+#include "include/bulkrenamedialog.h"
+#include "include/diffdialog.h"
+#include "include/dropscanner.h"
+#include "include/editjournal.h"
+#include "include/entrybatch.h"
+#include "include/lengthauditdialog.h"
+#include "include/midifile.h"
+#include "include/quickopendialog.h"
+#include "include/renamecommand.h"
+#include "include/sessionsnapshot.h"
+#include "include/unusedassetsdialog.h"
 #include "ui_program.h"
 #include <QDebug>
 #include <QDirIterator>
 #include <QDragEnterEvent>
 #include <QFileDialog>
-#include <QJsonArray>
-#include <QJsonDocument>
-#include <QJsonObject>
+#include <QFileInfo>
+#include <QInputDialog>
 #include <QMessageBox>
 #include <QMimeData>
-#include <QTextStream>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QtConcurrent>
+#include <algorithm>
 
 Program::Program(QWidget *parent) :
     QMainWindow(parent),
-    ui(new Ui::AkashiAssetConfigEditor)
+    ui(new Ui::AkashiAssetConfigEditor),
+    m_length_prober(&m_duration_cache),
+    m_animation_cache(new AnimationCache(QSize(256, 192), 64 * 1024, this)),
+    m_waveform_cache(new WaveformCache(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/waveforms", 16 * 1024, this))
 {
-    // Init GUI, BASS and config names
+    QElapsedTimer l_startup;
+    l_startup.start();
+
+    // Init GUI and config names, audio is initialized when it's needed
     ui->setupUi(this);
-    BASS_Init(-1, 48000, BASS_DEVICE_LATENCY, 0, 0);
-    m_configs.insert("/backgrounds.txt", ui->treebackgrounds);
-    m_configs.insert("/characters.txt", ui->treecharacters);
-    m_configs.insert("/music.txt", ui->treemusictxt);
-    m_configs.insert("/music.json", ui->treemusicjson);
+    m_workspace_bar = new QTabBar(ui->centralwidget);
+    m_workspace_bar->setGeometry(0, 0, 521, 24);
+    m_workspace_bar->setTabsClosable(true);
+    m_workspace_bar->setExpanding(false);
+    m_waveform = new WaveformWidget(ui->centralwidget);
+    m_waveform->setGeometry(530, 378, 261, 36);
+
+    // The first workspace uses trees from the form
+    m_workspace = new Workspace;
+    m_workspace->configs.insert("/backgrounds.txt", ui->treebackgrounds);
+    m_workspace->configs.insert("/characters.txt", ui->treecharacters);
+    m_workspace->configs.insert("/music.txt", ui->treemusictxt);
+    m_workspace->configs.insert("/music.json", ui->treemusicjson);
+    m_workspace->undo_stack = new QUndoStack(this);
+    m_undo_group.addStack(m_workspace->undo_stack);
+    m_undo_group.setActiveStack(m_workspace->undo_stack);
+    m_workspaces.append(m_workspace);
+    m_workspace_bar->addTab(tr("Untitled"));
+    for (QTreeWidget *l_tree : qAsConst(m_workspace->configs))
+        setupTree(l_tree);
+
+    m_duration_cache.load(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/durations.dat");
+    m_hash_cache.load(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/hashes.dat");
 
     // File panel signals (Open, save, and etc.)
     connect(ui->actionOpen_config_folder, &QAction::triggered, this, &Program::openConfigFolderClicked);
     connect(ui->actionOpen_base_folder, &QAction::triggered, this, &Program::openBaseFolderClicked);
+    connect(ui->actionCancel_loading, &QAction::triggered, this, &Program::cancelLoadingClicked);
     connect(ui->actionSave, &QAction::triggered, this, &Program::saveButtonPressed);
+    connect(&m_save_watcher, &QFutureWatcher<ConfigSaveResult>::finished, this, &Program::saveFinished);
+    connect(&m_save_watcher, &QFutureWatcher<ConfigSaveResult>::progressValueChanged, this, [this](int value) {
+        ui->statusbar->showMessage(tr("Saving... %1/%2").arg(value).arg(m_save_watcher.progressMaximum()));
+    });
     connect(ui->actionAbout, &QAction::triggered, this, &Program::aboutButtonClicked);
     connect(ui->actionExit, &QAction::triggered, this, &QCoreApplication::quit);
+    ui->actionRestore_session->setChecked(QSettings().value("restore_session", false).toBool());
+    connect(ui->actionRestore_session, &QAction::toggled, this, [](bool checked) { QSettings().setValue("restore_session", checked); });
+    connect(ui->actionCompare_folder, &QAction::triggered, this, &Program::compareFolderClicked);
+    connect(ui->actionExport_manifest, &QAction::triggered, this, &Program::exportManifestClicked);
+    connect(ui->actionVerify_manifest, &QAction::triggered, this, &Program::verifyManifestClicked);
+    connect(&m_manifest_watcher, &QFutureWatcher<ManifestEntry>::finished, this, &Program::manifestFinished);
+    connect(&m_manifest_watcher, &QFutureWatcher<ManifestEntry>::progressValueChanged, this, [this](int value) {
+        ui->statusbar->showMessage(tr("Hashing assets... %1/%2").arg(value).arg(m_manifest_watcher.progressMaximum()));
+    });
+    connect(ui->actionQuick_open, &QAction::triggered, this, &Program::quickOpenClicked);
+    connect(ui->actionFind_unused_assets, &QAction::triggered, this, &Program::findUnusedClicked);
+    connect(&m_unused_watcher, &QFutureWatcher<QVector<UnusedAsset>>::finished, this, &Program::unusedFinished);
+    connect(ui->actionAudit_lengths, &QAction::triggered, this, &Program::auditLengthsClicked);
+    connect(&m_audit_watcher, &QFutureWatcher<QVector<LengthCheck>>::finished, this, &Program::auditFinished);
+
+    // Edit panel (Undo, redo and bulk rename)
+    QAction *l_undo = m_undo_group.createUndoAction(this, tr("Undo"));
+    l_undo->setShortcut(QKeySequence::Undo);
+    QAction *l_redo = m_undo_group.createRedoAction(this, tr("Redo"));
+    l_redo->setShortcut(QKeySequence::Redo);
+    ui->editpanel->insertActions(ui->actionBulk_rename, {l_undo, l_redo});
+    ui->editpanel->insertSeparator(ui->actionBulk_rename);
+    connect(ui->actionBulk_rename, &QAction::triggered, this, &Program::bulkRenameClicked);
+    connect(ui->actionTranscode_to_Opus, &QAction::triggered, this, &Program::transcodeClicked);
+    connect(ui->actionDuplicate, &QAction::triggered, this, &Program::duplicateClicked);
+    connect(ui->actionMove_to_category, &QAction::triggered, this, &Program::moveToCategoryClicked);
+    connect(ui->actionSet_length, &QAction::triggered, this, &Program::setLengthClicked);
+    connect(ui->actionDelete, &QAction::triggered, this, &Program::deleteButtonPressed);
+    connect(&m_transcoder, &OpusTranscoder::songFinished, this, &Program::songTranscoded);
+    connect(&m_transcoder, &OpusTranscoder::finished, this, &Program::transcodeFinished);
+    connect(ui->actionSort_by_name, &QAction::triggered, this, [this] { sortClicked(EntrySorter::Name); });
+    connect(ui->actionSort_by_length, &QAction::triggered, this, [this] { sortClicked(EntrySorter::Length); });
+    connect(ui->actionSort_by_size, &QAction::triggered, this, [this] { sortClicked(EntrySorter::Size); });
+    connect(ui->actionNew_workspace, &QAction::triggered, this, &Program::newWorkspaceClicked);
+    connect(ui->actionClose_workspace, &QAction::triggered, this, [this] { closeWorkspace(m_workspace_bar->currentIndex()); });
+    connect(m_workspace_bar, &QTabBar::currentChanged, this, &Program::workspaceChanged);
+    connect(m_workspace_bar, &QTabBar::tabCloseRequested, this, &Program::closeWorkspace);
+    connect(&m_asset_index_watcher, &QFutureWatcher<AssetIndex>::finished, this, &Program::assetIndexFinished);
+    connect(&m_ini_watcher, &QFileSystemWatcher::fileChanged, this, &Program::iniFileChanged);
+    connect(&m_length_prober, &LengthProber::lengthProbed, this, &Program::lengthProbed);
 
     // Buttons, labels, lines signals (Background's positions/Character's animations, search/length lines, play, stop, add, delete buttons and etc)
     connect(ui->animbgList, &QComboBox::currentTextChanged, this, &Program::animBgListChanged);
+    connect(m_animation_cache, &AnimationCache::animationReady, this, &Program::animationReady);
+    connect(m_waveform_cache, &WaveformCache::waveformReady, this, &Program::waveformReady);
+    m_animation_timer.setSingleShot(true);
+    connect(&m_animation_timer, &QTimer::timeout, this, &Program::animationTimeout);
 
     connect(ui->clearconfigButton, &QPushButton::clicked, this, &Program::clearConfigButtonPressed);
     connect(ui->createconfigButton, &QPushButton::clicked, this, &Program::createConfigButtonPressed);
@@ -44,35 +130,34 @@ Program::Program(QWidget *parent) :
 
     connect(ui->playButton, &QPushButton::clicked, this, &Program::playButtonPressed);
     connect(ui->stopButton, &QPushButton::clicked, this, &Program::stopButtonPressed);
+    connect(ui->positionSlider, &QSlider::sliderMoved, this, [this](int value) { seekTo(value / 1000.0); });
+    connect(ui->loopButton, &QPushButton::toggled, this, &Program::loopToggled);
+    connect(m_waveform, &WaveformWidget::seekRequested, this, &Program::seekTo);
+    connect(m_waveform, &WaveformWidget::loopChanged, this, &Program::updateLoop);
+    m_position_timer.setInterval(POSITION_INTERVAL);
+    connect(&m_position_timer, &QTimer::timeout, this, &Program::positionTimeout);
 
     connect(ui->addCategoryButton, &QPushButton::clicked, this, &Program::addCategoryButtonPressed);
     connect(ui->deleteButton, &QPushButton::clicked, this, &Program::deleteButtonPressed);
 
     connect(ui->lengthLine, &QLineEdit::editingFinished, this, &Program::lengthEditingFinished);
     connect(ui->searchLine, &QLineEdit::textChanged, this, &Program::searchTextChanged);
+    connect(ui->filterModeBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this] { searchTextChanged(ui->searchLine->text()); });
 
-    // Click event signals (Select item)
-    connect(ui->treebackgrounds, &QTreeWidget::itemClicked, this, &Program::onItemClicked);
-    connect(ui->treecharacters, &QTreeWidget::itemClicked, this, &Program::onItemClicked);
-    connect(ui->treemusictxt, &QTreeWidget::itemClicked, this, &Program::onItemClicked);
-    connect(ui->treemusicjson, &QTreeWidget::itemClicked, this, &Program::onItemClicked);
+    // Accept dropped files on the window
+    setAcceptDrops(true);
+    connect(&m_drop_watcher, &QFutureWatcher<QStringList>::finished, this, &Program::dropScanFinished);
+    connect(&m_drop_timer, &QTimer::timeout, this, &Program::insertDropBatch);
 
-    // Double click event signals (Edit item's name)
-    connect(ui->treebackgrounds, &QTreeWidget::itemDoubleClicked, this, &Program::onItemDoubleClicked);
-    connect(ui->treecharacters, &QTreeWidget::itemDoubleClicked, this, &Program::onItemDoubleClicked);
-    connect(ui->treemusictxt, &QTreeWidget::itemDoubleClicked, this, &Program::onItemDoubleClicked);
-    connect(ui->treemusicjson, &QTreeWidget::itemDoubleClicked, this, &Program::onItemDoubleClicked);
+    // Unsaved edits are written to the journal in batches
+    m_journal_timer.setSingleShot(true);
+    connect(&m_journal_timer, &QTimer::timeout, this, &Program::flushJournals);
 
-    // Set drag and drop, and selection mode (Drop new files, select items)
-    setAcceptDrops(true);
-    ui->treebackgrounds->setSelectionMode(QAbstractItemView::ExtendedSelection);
-    ui->treebackgrounds->setDragDropMode(QAbstractItemView::InternalMove);
-    ui->treecharacters->setSelectionMode(QAbstractItemView::ExtendedSelection);
-    ui->treecharacters->setDragDropMode(QAbstractItemView::InternalMove);
-    ui->treemusictxt->setSelectionMode(QAbstractItemView::ExtendedSelection);
-    ui->treemusictxt->setDragDropMode(QAbstractItemView::InternalMove);
-    ui->treemusicjson->setSelectionMode(QAbstractItemView::ExtendedSelection);
-    ui->treemusicjson->setDragDropMode(QAbstractItemView::InternalMove);
+    if (ui->actionRestore_session->isChecked())
+        restoreSession();
+
+    if (l_startup.elapsed() > STARTUP_BUDGET)
+        qWarning() << "Startup is over the budget of" << STARTUP_BUDGET << "ms";
 }
 
 void Program::openConfigFolderClicked()
@@ -80,462 +165,2335 @@ void Program::openConfigFolderClicked()
     if (m_base_folder.isEmpty())
         QMessageBox::information(this, tr("Warning!"), tr("Without the base folder some functions are not available! Please, open the base folder too."));
 
-    m_config_folder = QFileDialog::getExistingDirectory();
+    QString l_folder = QFileDialog::getExistingDirectory();
+    if (l_folder.isEmpty())
+        return;
+
+    loadConfigFolder(l_folder);
+}
+
+void Program::loadConfigFolder(const QString &folder)
+{
+    qDebug() << "Config folder's path is: " + folder;
 
-    if (m_config_folder.isEmpty())
+    // Two workspaces of one folder would write into the same journal
+    Workspace *l_open = folderWorkspace(folder, m_workspace);
+    if (l_open != nullptr) {
+        m_workspace_bar->setCurrentIndex(m_workspaces.indexOf(l_open));
+        QMessageBox::information(this, tr("Warning!"), tr("This config folder is already open in another workspace!"));
         return;
+    }
+
+    // The last picked folder wins over the one that is still loading
+    Workspace *l_workspace = m_workspace;
+    if (l_workspace->loader != nullptr) {
+        l_workspace->loader->disconnect(this);
+        l_workspace->loader->cancel();
+        l_workspace->loader->deleteLater();
+    }
+
+    l_workspace->loader = new QFutureWatcher<ConfigLoadResult>(this);
+    connect(l_workspace->loader, &QFutureWatcher<ConfigLoadResult>::finished, this, [this, l_workspace, folder] { loadFinished(l_workspace, folder); });
+    connect(l_workspace->loader, &QFutureWatcher<ConfigLoadResult>::progressValueChanged, this, [this, l_workspace](int value) {
+        if (l_workspace == m_workspace)
+            ui->statusbar->showMessage(tr("Loading configs... %1/%2").arg(value).arg(l_workspace->loader->progressMaximum()));
+    });
+    l_workspace->loader->setFuture(ConfigFile::readAll(folder, l_workspace->configs.keys()));
+    ui->actionCancel_loading->setEnabled(true);
+    ui->statusbar->showMessage(tr("Loading configs..."));
+}
 
-    qDebug() << "Config folder's path is: " + m_config_folder;
+void Program::loadFinished(Workspace *workspace, const QString &folder)
+{
+    QFutureWatcher<ConfigLoadResult> *l_loader = workspace->loader;
+    workspace->loader = nullptr;
+    l_loader->deleteLater();
+    ui->actionCancel_loading->setEnabled(m_workspace->loader != nullptr);
+    if (l_loader->isCanceled()) {
+        ui->statusbar->showMessage(tr("Loading was canceled"), 3000);
+        return;
+    }
+    if (folderWorkspace(folder, workspace) != nullptr) { // Opened in another workspace during loading
+        ui->statusbar->showMessage(tr("This config folder is already open in another workspace"), 5000);
+        return;
+    }
 
     // Cleaning from loaded configs
-    m_music_length.clear();
-    ui->treebackgrounds->clear();
-    ui->treecharacters->clear();
-    ui->treemusictxt->clear();
-    ui->treemusicjson->clear();
+    flushJournals();
+    delete workspace->journal;
+    workspace->journal = nullptr;
+    unwatchIniFiles(workspace);
+    workspace->config_folder = folder;
+    workspace->music_length.clear();
+    workspace->undo_stack->clear();
+    if (workspace == m_workspace)
+        ui->animbgList->clear();
+    m_workspace_bar->setTabText(m_workspaces.indexOf(workspace), QDir(folder).dirName());
+
+    // All configs are swapped in at once, so the workspace never shows a mix of two folders
+    const QList<ConfigLoadResult> l_results = l_loader->future().results();
+    m_journal_paused++;
+    for (const ConfigLoadResult &l_result : l_results) {
+        QString l_suc = l_result.ok ? "Success!" : "Failure!";
+        qDebug() << "Loading " + l_result.key + "... " + l_suc;
+        workspace->stamps.insert(l_result.key, SessionSnapshot::stamp(folder + l_result.key));
+        fillConfig(workspace, l_result.key, l_result.entries);
+    }
+    m_journal_paused--;
+    loadIniFiles(workspace);
+
+    ui->statusbar->showMessage(tr("Loaded %1 configs").arg(l_results.size()), 3000);
+    recoverJournal(workspace);
+    compactStringPool();
+}
+
+void Program::cancelLoadingClicked()
+{
+    if (m_workspace->loader != nullptr)
+        m_workspace->loader->cancel(); // Finishes with loadFinished, that keeps the current configs
+}
+
+void Program::openBaseFolderClicked()
+{
+    m_base_folder = QFileDialog::getExistingDirectory();
+    qDebug() << "Base folder's path is: " + m_base_folder;
+
+    if (m_base_folder.isEmpty())
+        return;
+
+    scanBaseFolder();
+}
+
+void Program::scanBaseFolder()
+{
+    // Index assets once for all workspaces
+    QString l_base_folder = m_base_folder;
+    m_asset_index_watcher.setFuture(QtConcurrent::run([l_base_folder] { return AssetIndex::scan(l_base_folder); }));
+    ui->statusbar->showMessage(tr("Indexing base folder..."));
+}
+
+void Program::assetIndexFinished()
+{
+    AssetIndex l_index = m_asset_index_watcher.result();
+    if (l_index.baseFolder() != m_base_folder)
+        return;
+
+    m_asset_index = l_index;
+    ui->statusbar->showMessage(tr("Indexed %1 assets").arg(m_asset_index.count()), 5000);
+}
+
+void Program::newWorkspaceClicked()
+{
+    Workspace *l_workspace = new Workspace;
+    for (auto l_iter = m_workspace->configs.cbegin(); l_iter != m_workspace->configs.cend(); ++l_iter) {
+        QTreeWidget *l_tree = new QTreeWidget(l_iter.value()->parentWidget());
+        l_tree->setGeometry(l_iter.value()->geometry());
+        l_tree->setColumnCount(2);
+        l_tree->setHeaderHidden(true);
+        l_tree->setEditTriggers(QAbstractItemView::NoEditTriggers);
+        l_tree->hide();
+        setupTree(l_tree);
+        l_workspace->configs.insert(l_iter.key(), l_tree);
+    }
+
+    l_workspace->undo_stack = new QUndoStack(this);
+    m_undo_group.addStack(l_workspace->undo_stack);
+    m_workspaces.append(l_workspace);
+    m_workspace_bar->setCurrentIndex(m_workspace_bar->addTab(tr("Untitled")));
+}
+
+void Program::workspaceChanged(int index)
+{
+    if (index < 0 || m_workspaces[index] == m_workspace)
+        return;
+
+    for (QTreeWidget *l_tree : qAsConst(m_workspace->configs))
+        l_tree->hide();
+
+    m_workspace = m_workspaces[index];
+    m_undo_group.setActiveStack(m_workspace->undo_stack);
+    ui->actionCancel_loading->setEnabled(m_workspace->loader != nullptr);
+    for (QTreeWidget *l_tree : qAsConst(m_workspace->configs))
+        l_tree->show();
+
     ui->animbgList->clear();
+    ui->chariconLabel->clear();
+    ui->lengthLine->clear();
+    showWaveform(QString());
+    if (!ui->searchLine->text().isEmpty())
+        searchTextChanged(ui->searchLine->text());
+}
 
-    QFile l_file;
-    QStringList l_items;
-    QStringList l_keys = m_configs.keys();
+void Program::closeWorkspace(int index)
+{
+    if (m_workspaces.size() < 2 || index < 0)
+        return;
+
+    flushJournals();
+    Workspace *l_workspace = m_workspaces.takeAt(index);
+    m_workspace_bar->removeTab(index); // Switches m_workspace to the neighbour
+    unwatchIniFiles(l_workspace);
+    for (QTreeWidget *l_tree : qAsConst(l_workspace->configs))
+        delete l_tree;
+    delete l_workspace->undo_stack;
+    delete l_workspace->journal; // Unsaved edits stay in the journal until the folder is opened again
+    if (l_workspace->loader != nullptr) {
+        l_workspace->loader->disconnect(this);
+        l_workspace->loader->cancel();
+        l_workspace->loader->deleteLater();
+    }
+    delete l_workspace;
+
+    // Forget pending work of the closed workspace
+    if (m_audit_workspace == l_workspace)
+        m_audit_workspace = nullptr;
+    if (m_save_workspace == l_workspace)
+        m_save_workspace = nullptr;
+    if (m_transcode_workspace == l_workspace)
+        m_transcode_workspace = nullptr;
+    if (m_drop_workspace == l_workspace) {
+        m_drop_workspace = nullptr;
+        m_drop_items.clear();
+        m_drop_timer.stop();
+    }
+    for (auto l_iter = m_length_requests.begin(); l_iter != m_length_requests.end();)
+        if (l_iter.value().first == l_workspace)
+            l_iter = m_length_requests.erase(l_iter);
+        else
+            ++l_iter;
+    compactStringPool();
+}
+
+void Program::setupTree(QTreeWidget *tree)
+{
+    // Click event signals (Select item, edit item's name)
+    connect(tree, &QTreeWidget::itemClicked, this, &Program::onItemClicked);
+    connect(tree, &QTreeWidget::itemDoubleClicked, this, &Program::onItemDoubleClicked);
+    connect(tree, &QTreeWidget::itemExpanded, this, &Program::onItemExpanded);
+
+    // Renaming, adding, deleting and moving items go to the journal and the usage index
+    connect(tree, &QTreeWidget::itemChanged, this, &Program::journalRenamed);
+    connect(tree, &QTreeWidget::itemChanged, this, &Program::usageRenamed);
+    connect(tree->model(), &QAbstractItemModel::rowsInserted, this, [this, tree](const QModelIndex &parent, int first, int last) { rowsChanged(tree, parent, first, last, true); });
+    connect(tree->model(), &QAbstractItemModel::rowsAboutToBeRemoved, this, [this, tree](const QModelIndex &parent, int first, int last) { rowsChanged(tree, parent, first, last, false); });
+    connect(tree->model(), &QAbstractItemModel::modelReset, this, [this, tree] {
+        Workspace *l_workspace = treeWorkspace(tree);
+        if (m_journal_paused == 0 && l_workspace != nullptr)
+            l_workspace->usage.invalidate(l_workspace->configs.key(tree));
+        journalChanged(tree);
+    });
+
+    // Set drag and drop, and selection mode (Drop new files, select items)
+    tree->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    tree->setDragDropMode(QAbstractItemView::InternalMove);
+}
+
+void Program::saveButtonPressed()
+{
+    if (m_workspace->config_folder.isEmpty())
+        m_workspace->config_folder = QFileDialog::getExistingDirectory(); // Get directory to save created from scratch configs
+
+    if (m_workspace->config_folder.isEmpty())
+        return;
+
+    if (m_save_watcher.isRunning()) {
+        ui->statusbar->showMessage(tr("Still saving, try again later"), 3000);
+        return;
+    }
+
+    // Configs are written from a copy, so editing goes on during saving
+    QMap<QString, QVector<ConfigEntry>> l_configs;
+    m_save_configs.clear();
+    QStringList l_keys = m_workspace->configs.keys();
     for (const QString &l_key : qAsConst(l_keys)) {
-        Qt::ItemFlags l_flags;
-        if (l_key == l_keys[0] || l_key == l_keys[1])
-            l_flags = m_item_flags;
+        JournalConfig l_saved;
+        forEachEntry(m_workspace->configs[l_key], [&l_saved](int id, const QString &name) {
+            l_saved.ids.append(id);
+            l_saved.names.append(name);
+        });
+        if (l_saved.ids.isEmpty())
+            continue;
+
+        l_configs.insert(l_key, configEntries(l_key));
+        m_save_configs.insert(l_key, l_saved);
+    }
+
+    if (l_configs.isEmpty())
+        return;
+
+    m_save_workspace = m_workspace;
+    m_save_lengths = m_workspace->music_length;
+    m_save_edits = m_workspace->journal != nullptr ? m_workspace->journal->edits() : 0;
+    m_save_watcher.setFuture(ConfigFile::writeAll(m_workspace->config_folder, l_configs));
+    ui->statusbar->showMessage(tr("Saving... 0/%1").arg(l_configs.size()));
+}
+
+void Program::saveFinished()
+{
+    const QList<ConfigSaveResult> l_results = m_save_watcher.future().results();
+    Workspace *l_workspace = m_save_workspace; // Null if the workspace was closed during saving
+    m_save_workspace = nullptr;
+
+    QStringList l_failures;
+    for (const ConfigSaveResult &l_result : l_results) {
+        QString l_suc = l_result.ok ? "Success!" : "Failure!";
+        qDebug() << "Saving " + l_result.key + "... " + l_suc;
+        if (!l_result.ok)
+            l_failures.append(l_result.key.mid(1) + ": " + l_result.error);
+        else if (l_workspace != nullptr)
+            l_workspace->stamps.insert(l_result.key, SessionSnapshot::stamp(l_workspace->config_folder + l_result.key));
+    }
+
+    if (!l_failures.isEmpty()) {
+        ui->statusbar->clearMessage();
+        QMessageBox::warning(this, tr("Warning!"), tr("Can't save %1 of %2 configs:\n%3").arg(l_failures.size()).arg(l_results.size()).arg(l_failures.join("\n")));
+        return;
+    }
+
+    if (l_workspace != nullptr)
+        compactJournal(l_workspace);
+    ui->statusbar->showMessage(tr("Saved %1 configs").arg(l_results.size()), 3000);
+}
+
+void Program::saveSession()
+{
+    QVector<SessionWorkspace> l_workspaces;
+    for (const Workspace *l_workspace : qAsConst(m_workspaces)) {
+        SessionWorkspace l_session;
+        l_session.config_folder = l_workspace->config_folder;
+        l_session.stamps = l_workspace->stamps;
+        l_session.music_length = l_workspace->music_length;
+        for (auto l_iter = l_workspace->configs.cbegin(); l_iter != l_workspace->configs.cend(); ++l_iter) {
+            JournalConfig &l_config = l_session.configs[l_iter.key()];
+            forEachEntry(l_iter.value(), [&l_config](int id, const QString &name) {
+                l_config.ids.append(id);
+                l_config.names.append(name);
+            });
+        }
+        l_workspaces.append(l_session);
+    }
+
+    AssetIndex l_index = m_asset_index.baseFolder() == m_base_folder ? m_asset_index : AssetIndex();
+    SessionSnapshot::write(SessionSnapshot::location(), l_index, l_workspaces);
+}
+
+void Program::restoreSession()
+{
+    QElapsedTimer l_timer;
+    l_timer.start();
+
+    AssetIndex l_index;
+    QVector<SessionWorkspace> l_workspaces;
+    bool l_ok = SessionSnapshot::read(SessionSnapshot::location(), &l_index, &l_workspaces);
+    QFile::remove(SessionSnapshot::location()); // After a crash the journal is newer than the snapshot
+    if (!l_ok)
+        return;
+
+    if (!l_index.baseFolder().isEmpty() && QDir(l_index.baseFolder()).exists()) {
+        m_base_folder = l_index.baseFolder();
+        if (l_index.isCurrent())
+            m_asset_index = l_index;
         else
-            l_flags = m_category_flags;
-
-        l_file.setFileName(m_config_folder + l_key);
-        l_file.open(QIODevice::ReadOnly | QIODevice::Text);
-        if (l_key != l_keys[2]) // Load backgrounds.txt, characters.txt and music.txt
-            while (!l_file.atEnd())
-                l_items.append(l_file.readLine().trimmed());
-        else { // Load music.json
-            QJsonArray l_list = QJsonDocument::fromJson(l_file.readAll()).array();
-            QJsonObject l_object;
-            QJsonArray l_array;
-            for (int i = 0; i < l_list.size(); i++) {
-                l_object = l_list.at(i).toObject();
-                QString l_category = l_object["category"].toString();
-                if (!l_category.isEmpty()) {
-                    l_items.append(l_category);
-                    m_music_length.append("category");
-                }
+            scanBaseFolder();
+    }
+
+    for (int i = 0; i < l_workspaces.size(); i++) {
+        const SessionWorkspace &l_session = l_workspaces[i];
+        if (!l_session.config_folder.isEmpty() && folderWorkspace(l_session.config_folder, nullptr) != nullptr)
+            continue;
+
+        if (i > 0)
+            newWorkspaceClicked();
+        bool l_current = true;
+        for (auto l_iter = l_session.stamps.cbegin(); l_iter != l_session.stamps.cend(); ++l_iter) {
+            AssetInfo l_stamp = SessionSnapshot::stamp(l_session.config_folder + l_iter.key());
+            l_current = l_current && l_stamp.size == l_iter->size && l_stamp.modified == l_iter->modified;
+        }
+
+        if (!l_current) { // Configs were changed outside of the editor
+            loadConfigFolder(l_session.config_folder);
+            continue;
+        }
+
+        m_journal_paused++;
+        m_workspace->config_folder = l_session.config_folder;
+        m_workspace->stamps = l_session.stamps;
+        m_workspace->music_length = l_session.music_length;
+        for (auto l_iter = l_session.configs.cbegin(); l_iter != l_session.configs.cend(); ++l_iter) {
+            QTreeWidget *l_tree = m_workspace->configs.value(l_iter.key());
+            if (l_tree != nullptr)
+                addItems(l_iter->names, l_tree, ConfigFile::hasCategories(l_iter.key()) ? m_category_flags : m_item_flags, l_iter->ids);
+        }
+        m_journal_paused--;
+
+        // The snapshot has edits of the journal, so it goes on
+        if (!m_workspace->config_folder.isEmpty()) {
+            loadIniFiles(m_workspace);
+            m_workspace->journal = new EditJournal(EditJournal::location(m_workspace->config_folder));
+            m_workspace_bar->setTabText(m_workspace_bar->currentIndex(), QDir(m_workspace->config_folder).dirName());
+        }
+    }
+
+    m_workspace_bar->setCurrentIndex(0);
+    ui->statusbar->showMessage(tr("Session restored in %1 ms").arg(l_timer.elapsed()), 5000);
+}
+
+void Program::recoverJournal(Workspace *workspace)
+{
+    QString l_filename = EditJournal::location(workspace->config_folder);
+    QMap<QString, JournalConfig> l_configs;
+    QStringList l_lengths = workspace->music_length;
+    for (auto l_iter = workspace->configs.cbegin(); l_iter != workspace->configs.cend(); ++l_iter) {
+        JournalConfig &l_config = l_configs[l_iter.key()];
+        forEachEntry(l_iter.value(), [&l_config](int id, const QString &name) {
+            l_config.ids.append(id);
+            l_config.names.append(name);
+        });
+    }
+
+    QSet<QString> l_changed;
+    int l_edits = QFile::exists(l_filename) ? EditJournal::replay(l_filename, &l_configs, &l_lengths, &l_changed) : 0;
+    bool l_restore = l_edits > 0 && QMessageBox::question(this, tr("Restore"), tr("There are %1 unsaved edits of this config folder from the previous session. Restore them?").arg(l_edits)) == QMessageBox::Yes;
+
+    workspace->journal = new EditJournal(l_filename);
+    if (!l_restore) { // Ids of the journal match only the restored session
+        workspace->journal->reset();
+        return;
+    }
+
+    m_journal_paused++;
+    workspace->music_length = l_lengths;
+    for (const QString &l_key : qAsConst(l_changed)) {
+        QTreeWidget *l_tree = workspace->configs.value(l_key);
+        if (l_tree == nullptr)
+            continue;
+
+        const JournalConfig &l_config = l_configs[l_key];
+        l_tree->clear();
+        addItems(l_config.names, l_tree, ConfigFile::hasCategories(l_key) ? m_category_flags : m_item_flags, l_config.ids);
+        workspace->usage.invalidate(l_key);
+    }
+    m_journal_paused--;
+
+    ui->statusbar->showMessage(tr("Restored %1 unsaved edits").arg(l_edits), 5000);
+}
+
+void Program::compactJournal(Workspace *workspace)
+{
+    if (workspace->journal == nullptr)
+        workspace->journal = new EditJournal(EditJournal::location(workspace->config_folder));
+
+    // Saved configs are the new start of the journal, with ids of this session
+    workspace->journal->reset();
+    for (auto l_iter = m_save_configs.cbegin(); l_iter != m_save_configs.cend(); ++l_iter) {
+        QStringList l_lengths;
+        if (ConfigFile::hasLengths(l_iter.key()))
+            for (int l_id : l_iter->ids)
+                l_lengths.append(m_save_lengths.value(l_id - 1, "0"));
+        workspace->journal->recordSnapshot(l_iter.key(), l_iter->ids, l_iter->names, l_lengths, true);
+    }
+
+    // Edits made during saving aren't saved
+    if (workspace->journal->edits() != m_save_edits) {
+        for (auto l_iter = workspace->configs.cbegin(); l_iter != workspace->configs.cend(); ++l_iter)
+            workspace->journal->markDirty(l_iter.key());
+        m_journal_timer.start(JOURNAL_DELAY);
+    }
+    workspace->journal->flush();
+}
+
+void Program::journalSnapshot(Workspace *workspace, const QString &key)
+{
+    QVector<int> l_ids;
+    QStringList l_names;
+    QStringList l_lengths;
+    bool l_has_lengths = ConfigFile::hasLengths(key);
+    forEachEntry(workspace->configs[key], [workspace, &l_ids, &l_names, &l_lengths, l_has_lengths](int id, const QString &name) {
+        l_ids.append(id);
+        l_names.append(name);
+        if (l_has_lengths)
+            l_lengths.append(workspace->music_length.value(id - 1, "0"));
+    });
+
+    workspace->journal->recordSnapshot(key, l_ids, l_names, l_lengths);
+}
+
+void Program::journalChanged(QTreeWidget *tree)
+{
+    Workspace *l_workspace = treeWorkspace(tree);
+    if (m_journal_paused > 0 || l_workspace == nullptr || l_workspace->journal == nullptr)
+        return;
+
+    l_workspace->journal->markDirty(l_workspace->configs.key(tree));
+    m_journal_timer.start(JOURNAL_DELAY);
+}
+
+void Program::journalReordered(Workspace *workspace, const QString &key, int category, const PendingChildren &children)
+{
+    // Songs that aren't created yet are item data, so the model sends no signal for them
+    if (m_journal_paused > 0 || workspace->journal == nullptr)
+        return;
+
+    QStringList l_names;
+    l_names.reserve(children.names.size());
+    for (int l_name : children.names)
+        l_names.append(m_string_pool.name(l_name));
+    workspace->journal->recordRemove(key, children.ids);
+    workspace->journal->recordInsert(key, category, children.ids, l_names);
+    m_journal_timer.start(JOURNAL_DELAY);
+}
+
+void Program::journalRenamed(QTreeWidgetItem *item, int column)
+{
+    Workspace *l_workspace = treeWorkspace(item->treeWidget());
+    if (m_journal_paused > 0 || column != 1 || l_workspace == nullptr || l_workspace->journal == nullptr)
+        return;
+
+    l_workspace->journal->recordRename(l_workspace->configs.key(item->treeWidget()), item->text(0).toInt(), item->text(1));
+    m_journal_timer.start(JOURNAL_DELAY);
+}
+
+void Program::rowsChanged(QTreeWidget *tree, const QModelIndex &parent, int first, int last, bool added)
+{
+    Workspace *l_workspace = treeWorkspace(tree);
+    if (m_journal_paused > 0 || l_workspace == nullptr)
+        return;
+
+    // Rows are two levels deep, so the parent is a top-level row if there is one
+    QTreeWidgetItem *l_parent = EntryBatch::parentItem(tree, parent.isValid() ? parent.row() : -1);
+    QVector<int> l_ids;
+    QStringList l_names;
+    for (int i = first; i <= last && i < l_parent->childCount(); i++)
+        forEachEntry(l_parent->child(i), [&l_ids, &l_names](int id, const QString &name) {
+            l_ids.append(id);
+            l_names.append(name);
+        });
+
+    QString l_key = l_workspace->configs.key(tree);
+    if (added)
+        l_workspace->usage.addNames(l_key, l_names);
+    else
+        l_workspace->usage.removeNames(l_key, l_names);
+
+    if (l_workspace->journal == nullptr || l_ids.isEmpty())
+        return;
+
+    if (!added) {
+        l_workspace->journal->recordRemove(l_key, l_ids);
+    }
+    else {
+        // Entries of a category come after it and its songs that aren't created yet
+        int l_after = 0;
+        if (first > 0)
+            l_after = lastEntryId(l_parent->child(first - 1));
+        else if (parent.isValid())
+            l_after = pendingChildren(l_parent).ids.isEmpty() ? l_parent->text(0).toInt() : pendingChildren(l_parent).ids.last();
+        l_workspace->journal->recordInsert(l_key, l_after, l_ids, l_names);
+    }
+    m_journal_timer.start(JOURNAL_DELAY);
+}
+
+int Program::lastEntryId(QTreeWidgetItem *item)
+{
+    if (item->childCount() > 0)
+        return lastEntryId(item->child(item->childCount() - 1));
+
+    PendingChildren l_children = pendingChildren(item);
+    return l_children.ids.isEmpty() ? item->text(0).toInt() : l_children.ids.last();
+}
+
+void Program::usageRenamed(QTreeWidgetItem *item, int column)
+{
+    Workspace *l_workspace = treeWorkspace(item->treeWidget());
+    if (m_journal_paused > 0 || column != 1 || l_workspace == nullptr)
+        return;
+
+    // Only names edited in place are known before the change, anything else reindexes the config
+    QString l_key = l_workspace->configs.key(item->treeWidget());
+    if (item != m_edited_item) {
+        l_workspace->usage.invalidate(l_key);
+        return;
+    }
+
+    l_workspace->usage.removeNames(l_key, {m_edited_name});
+    l_workspace->usage.addNames(l_key, {item->text(1)});
+    m_edited_name = item->text(1);
+}
+
+void Program::journalLength(Workspace *workspace, int id)
+{
+    if (workspace->journal == nullptr || id > workspace->music_length.size())
+        return;
+
+    workspace->journal->recordLength(id, workspace->music_length[id - 1]);
+    if (!m_journal_timer.isActive())
+        m_journal_timer.start(JOURNAL_DELAY);
+}
+
+void Program::loadIniFiles(Workspace *workspace)
+{
+    workspace->usage.clear(); // Configs are reindexed on the first lookup
+    for (const QString &l_key : workspace->configs.keys())
+        workspace->usage.invalidate(l_key);
+
+    QDir l_folder(workspace->config_folder);
+    const QStringList l_files = l_folder.entryList({"*.ini"}, QDir::Files);
+    for (const QString &l_file : l_files) {
+        workspace->usage.setIni(l_file, UsageIndex::readIni(l_folder.filePath(l_file)));
+        m_ini_watcher.addPath(l_folder.filePath(l_file));
+    }
+}
+
+void Program::unwatchIniFiles(Workspace *workspace)
+{
+    QDir l_folder(workspace->config_folder);
+    for (const Workspace *l_workspace : qAsConst(m_workspaces))
+        if (l_workspace != workspace && QDir(l_workspace->config_folder) == l_folder)
+            return;
+
+    const QStringList l_sources = workspace->usage.iniSources();
+    for (const QString &l_source : l_sources)
+        m_ini_watcher.removePath(l_folder.filePath(l_source));
+}
+
+void Program::iniFileChanged(const QString &path)
+{
+    QFileInfo l_info(path);
+    bool l_used = false;
+    for (Workspace *l_workspace : qAsConst(m_workspaces)) {
+        if (QDir(l_workspace->config_folder) != l_info.dir())
+            continue;
+
+        l_used = true;
+        if (l_info.exists())
+            l_workspace->usage.setIni(l_info.fileName(), UsageIndex::readIni(path));
+        else
+            l_workspace->usage.removeSource(l_info.fileName());
+    }
+
+    // Editors that save by replacing the file remove it from the watcher
+    if (!l_used)
+        m_ini_watcher.removePath(path);
+    else if (l_info.exists() && !m_ini_watcher.files().contains(path))
+        m_ini_watcher.addPath(path);
+}
+
+QVector<AssetUse> Program::assetUses(Workspace *workspace, const QString &asset)
+{
+    const QStringList l_stale = workspace->usage.takeStale();
+    for (const QString &l_key : l_stale) {
+        QTreeWidget *l_tree = workspace->configs.value(l_key);
+        if (l_tree == nullptr)
+            continue;
+
+        QStringList l_names;
+        forEachEntry(l_tree, [&l_names](int, const QString &name) { l_names.append(name); });
+        workspace->usage.setConfig(l_key, l_names);
+    }
+
+    return workspace->usage.uses(asset);
+}
+
+QStringList Program::describeUses(const QVector<AssetUse> &uses, const QString &skip)
+{
+    QStringList l_places;
+    for (const AssetUse &l_use : uses) {
+        if (l_use.source == skip)
+            continue;
+
+        if (l_use.section.isEmpty())
+            l_places.append(l_use.source.mid(1));
+        else
+            l_places.append(QString("%1 [%2] %3").arg(l_use.source, l_use.section, l_use.key));
+    }
+    return l_places;
+}
+
+void Program::flushJournals()
+{
+    for (Workspace *l_workspace : qAsConst(m_workspaces)) {
+        if (l_workspace->journal == nullptr)
+            continue;
+
+        // A long journal is started again from the current configs, so it doesn't grow until the next save
+        QStringList l_keys = l_workspace->journal->takeDirty();
+        if (l_workspace->journal->size() > MAX_JOURNAL_SIZE) {
+            l_workspace->journal->reset();
+            l_keys = l_workspace->configs.keys();
+        }
+        for (const QString &l_key : qAsConst(l_keys))
+            journalSnapshot(l_workspace, l_key);
+        l_workspace->journal->flush();
+    }
+}
+
+Workspace *Program::folderWorkspace(const QString &folder, const Workspace *except)
+{
+    for (Workspace *l_workspace : qAsConst(m_workspaces))
+        if (l_workspace != except && !l_workspace->config_folder.isEmpty() && QDir(l_workspace->config_folder) == QDir(folder))
+            return l_workspace;
+
+    return nullptr;
+}
+
+Workspace *Program::treeWorkspace(QTreeWidget *tree)
+{
+    for (Workspace *l_workspace : qAsConst(m_workspaces))
+        if (!l_workspace->configs.key(tree).isEmpty())
+            return l_workspace;
+
+    return nullptr;
+}
+
+void Program::compareFolderClicked()
+{
+    QString l_folder = QFileDialog::getExistingDirectory(this, tr("Compare with config folder"));
+    if (l_folder.isEmpty())
+        return;
+
+    QMap<QString, QVector<ConfigEntry>> l_current;
+    QMap<QString, QVector<ConfigEntry>> l_other;
+    QStringList l_keys = m_workspace->configs.keys();
+    for (const QString &l_key : qAsConst(l_keys)) {
+        l_current.insert(l_key, configEntries(l_key));
+        l_other.insert(l_key, ConfigFile::read(l_folder, l_key));
+    }
+
+    DiffDialog l_dialog(l_current, l_other, this);
+    connect(&l_dialog, &DiffDialog::applyToCurrent, this, &Program::setConfigEntries);
+    connect(&l_dialog, &DiffDialog::applyToOther, this, [this, l_folder](QString key, QVector<ConfigEntry> entries) {
+        QString l_error;
+        if (!ConfigFile::write(l_folder, key, entries, &l_error))
+            QMessageBox::warning(this, tr("Warning!"), tr("Can't write %1: %2").arg(l_folder + key, l_error));
+    });
+    l_dialog.exec();
+}
+
+void Program::findUnusedClicked()
+{
+    if (m_unused_watcher.isRunning())
+        return;
+
+    if (m_base_folder.isEmpty() || m_asset_index.isEmpty()) {
+        QMessageBox::information(this, tr("Warning!"), tr("Without the indexed base folder, this function is not available!"));
+        return;
+    }
+
+    // Assets of any opened workspace are used, configs and areas of all of them share the base folder
+    QSet<QString> l_used;
+    for (Workspace *l_workspace : qAsConst(m_workspaces)) {
+        assetUses(l_workspace, QString()); // Reindexes changed configs
+        const QStringList l_names = l_workspace->usage.assets();
+        for (const QString &l_name : l_names)
+            for (const QString &l_path : UnusedAssets::referencedPaths(l_name))
+                l_used.insert(l_path);
+    }
+    if (l_used.isEmpty()) { // Everything would be unused
+        QMessageBox::information(this, tr("Warning!"), tr("Open a config folder first!"));
+        return;
+    }
+
+    AssetIndex l_index = m_asset_index;
+    m_unused_timer.start();
+    m_unused_watcher.setFuture(QtConcurrent::run([l_index, l_used] { return UnusedAssets::find(l_index, l_used); }));
+    ui->statusbar->showMessage(tr("Looking for unused assets..."));
+}
+
+void Program::unusedFinished()
+{
+    ui->statusbar->clearMessage();
+    UnusedAssetsDialog l_dialog(m_unused_watcher.result(), m_unused_timer.elapsed(), this);
+    if (l_dialog.exec() != QDialog::Accepted)
+        return;
+
+    const QVector<UnusedAsset> l_assets = l_dialog.checkedAssets();
+    if (l_assets.isEmpty())
+        return;
+
+    QString l_archive = QFileDialog::getExistingDirectory(this, tr("Archive folder"));
+    if (l_archive.isEmpty())
+        return;
+    if (QDir(l_archive).absolutePath().startsWith(QDir(m_base_folder).absolutePath() + "/")) {
+        QMessageBox::information(this, tr("Warning!"), tr("The archive folder must be outside of the base folder!"));
+        return;
+    }
+
+    QStringList l_failures = UnusedAssets::archive(m_base_folder, l_assets, l_archive);
+    qint64 l_size = 0;
+    for (const UnusedAsset &l_asset : l_assets)
+        if (!l_failures.contains(l_asset.path))
+            l_size += l_asset.size;
+    if (!l_failures.isEmpty())
+        QMessageBox::warning(this, tr("Warning!"), tr("Can't move %1 of %2 assets:\n%3").arg(l_failures.size()).arg(l_assets.size()).arg(l_failures.mid(0, 10).join("\n")));
+
+    scanBaseFolder();
+    ui->statusbar->showMessage(tr("Moved %1 assets, %2 reclaimed").arg(l_assets.size() - l_failures.size()).arg(UnusedAssetsDialog::formatSize(l_size)), 5000);
+}
+
+void Program::auditLengthsClicked()
+{
+    if (m_audit_watcher.isRunning())
+        return;
+
+    if (m_base_folder.isEmpty()) {
+        QMessageBox::information(this, tr("Warning!"), tr("Without the base folder, this function is not available!"));
+        return;
+    }
+
+    QSettings l_settings;
+    bool l_ok;
+    double l_tolerance = QInputDialog::getDouble(this, tr("Audit song lengths"), tr("Report lengths that differ from the files by more than, in seconds:"),
+                                                 l_settings.value("length_tolerance", 1.0).toDouble(), 0, 3600, 2, &l_ok);
+    if (!l_ok)
+        return;
+    l_settings.setValue("length_tolerance", l_tolerance);
+
+    QVector<LengthCheck> l_songs;
+    const QStringList &l_lengths = m_workspace->music_length;
+    forEachEntry(m_workspace->configs["/music.json"], [&l_songs, &l_lengths](int id, const QString &name) {
+        QString l_length = l_lengths.value(id - 1, "0");
+        if (l_length == "category" || ConfigFile::isCategory(name))
+            return;
+
+        LengthCheck l_song;
+        l_song.id = id;
+        l_song.name = name;
+        l_song.stored = l_length;
+        l_songs.append(l_song);
+    });
+    if (l_songs.isEmpty()) {
+        QMessageBox::information(this, tr("Warning!"), tr("There are no songs in music.json!"));
+        return;
+    }
+
+    m_audit_workspace = m_workspace;
+    m_audit_total = l_songs.size();
+    QString l_folder = m_base_folder + "/sounds/music";
+    DurationCache *l_cache = &m_duration_cache;
+    m_audit_timer.start();
+    m_audit_watcher.setFuture(QtConcurrent::run([l_folder, l_songs, l_cache, l_tolerance] { return LengthAudit::audit(l_folder, l_songs, l_cache, l_tolerance); }));
+    ui->statusbar->showMessage(tr("Auditing lengths of %1 songs...").arg(l_songs.size()));
+}
+
+void Program::auditFinished()
+{
+    ui->statusbar->clearMessage();
+    Workspace *l_workspace = m_audit_workspace;
+    if (l_workspace == nullptr) // Closed while auditing
+        return;
+
+    LengthAuditDialog l_dialog(m_audit_watcher.result(), m_audit_total, m_audit_timer.elapsed(), this);
+    if (l_dialog.exec() != QDialog::Accepted)
+        return;
+
+    // Lengths edited while auditing are kept
+    int l_fixed = 0;
+    const QVector<LengthCheck> l_songs = l_dialog.checkedSongs();
+    for (const LengthCheck &l_song : l_songs) {
+        if (l_song.id > l_workspace->music_length.size() || l_workspace->music_length[l_song.id - 1] != l_song.stored)
+            continue;
+
+        l_workspace->music_length[l_song.id - 1] = QString::number(l_song.actual);
+        journalLength(l_workspace, l_song.id);
+        l_fixed++;
+    }
+
+    QTreeWidgetItem *l_current = l_workspace->configs["/music.json"]->currentItem();
+    if (l_workspace == m_workspace && l_current != nullptr)
+        ui->lengthLine->setText(m_workspace->music_length.value(l_current->text(0).toInt() - 1));
+    ui->statusbar->showMessage(tr("Fixed %1 lengths").arg(l_fixed), 5000);
+}
+
+void Program::exportManifestClicked()
+{
+    if (m_manifest_watcher.isRunning())
+        return;
+
+    if (m_base_folder.isEmpty() || m_asset_index.isEmpty()) {
+        QMessageBox::information(this, tr("Warning!"), tr("Without the indexed base folder, this function is not available!"));
+        return;
+    }
+
+    QString l_filename = QFileDialog::getSaveFileName(this, tr("Export asset manifest"), m_base_folder + "/manifest.txt");
+    if (l_filename.isEmpty())
+        return;
+
+    QMap<QString, QVector<ConfigEntry>> l_configs;
+    QStringList l_keys = m_workspace->configs.keys();
+    for (const QString &l_key : qAsConst(l_keys))
+        l_configs.insert(l_key, configEntries(l_key));
+
+    m_manifest_file = l_filename;
+    m_manifest_expected.clear();
+    m_manifest_timer.start();
+    m_manifest_watcher.setFuture(AssetManifest::hash(m_base_folder, AssetManifest::referencedAssets(l_configs, m_asset_index), &m_hash_cache));
+}
+
+void Program::verifyManifestClicked()
+{
+    if (m_manifest_watcher.isRunning())
+        return;
+
+    QString l_filename = QFileDialog::getOpenFileName(this, tr("Open asset manifest"), m_base_folder);
+    if (l_filename.isEmpty())
+        return;
+
+    QString l_folder = QFileDialog::getExistingDirectory(this, tr("Folder to verify"), m_base_folder);
+    if (l_folder.isEmpty())
+        return;
+
+    bool l_ok;
+    m_manifest_expected = AssetManifest::read(l_filename, &l_ok);
+    if (!l_ok) {
+        QMessageBox::warning(this, tr("Warning!"), tr("Can't read %1").arg(l_filename));
+        return;
+    }
+
+    QStringList l_paths;
+    l_paths.reserve(m_manifest_expected.size());
+    for (const ManifestEntry &l_entry : qAsConst(m_manifest_expected))
+        l_paths.append(l_entry.path);
+
+    m_manifest_file.clear();
+    m_manifest_timer.start();
+    m_manifest_watcher.setFuture(AssetManifest::hash(l_folder, l_paths, &m_hash_cache));
+}
+
+void Program::manifestFinished()
+{
+    const QList<ManifestEntry> l_results = m_manifest_watcher.future().results();
+    QVector<ManifestEntry> l_entries;
+    l_entries.reserve(l_results.size());
+    for (const ManifestEntry &l_entry : l_results)
+        l_entries.append(l_entry);
+
+    qint64 l_elapsed = m_manifest_timer.elapsed();
+    if (!m_manifest_file.isEmpty()) {
+        if (AssetManifest::write(m_manifest_file, l_entries))
+            ui->statusbar->showMessage(tr("Exported %1 assets in %2 ms").arg(l_entries.size()).arg(l_elapsed), 5000);
+        else
+            QMessageBox::warning(this, tr("Warning!"), tr("Can't write %1").arg(m_manifest_file));
+        return;
+    }
+
+    QStringList l_problems = AssetManifest::verify(m_manifest_expected, l_entries);
+    ui->statusbar->showMessage(tr("Verified %1 assets in %2 ms").arg(m_manifest_expected.size()).arg(l_elapsed), 5000);
+    if (l_problems.isEmpty()) {
+        QMessageBox::information(this, tr("Verify"), tr("All %1 assets match the manifest.").arg(m_manifest_expected.size()));
+        return;
+    }
+
+    QMessageBox l_box(QMessageBox::Warning, tr("Verify"), tr("%1 of %2 assets don't match the manifest.").arg(l_problems.size()).arg(m_manifest_expected.size()), QMessageBox::Ok, this);
+    l_box.setDetailedText(l_problems.join("\n"));
+    l_box.exec();
+}
+
+void Program::aboutButtonClicked()
+{
+    QMessageBox::about(this, tr("About"), tr("<h2>Akashi Asset Config Editor</h2>"
+                                             "<p>Simple program for adding/deleting assets on the server.</p>"
+                                             "<p>Created by Ddedinya</p>"
+                                             "<p>Source code: <a href='https://github.com/Ddedinya/Akashi-Asset-Config-Editor'>https://github.com/Ddedinya/Akashi-Asset-Config-Editor</a></p>"
+                                             "<p>The program and the author have nothing to do with the Attorney Online 2 developers!</p>"));
+}
+
+void Program::animBgListChanged(QString filename)
+{
+    m_animation_timer.stop();
+    m_animation_path.clear();
+    if (filename.isEmpty() || getCurrentTree()->currentItem() == nullptr)
+        return;
+
+    QString l_path = m_base_folder + getCurrentFolder() + getCurrentTree()->currentItem()->text(1) + "/" + filename;
+    m_animation_path = l_path;
+    if (m_animation_cache->find(l_path) != nullptr) {
+        animationReady(l_path);
+        return;
+    }
+
+    // Show the first frame while the rest is decoding
+    ui->animbgLabel->setPixmap(QPixmap(l_path).scaled(256, 192));
+    m_animation_cache->request(l_path);
+}
+
+void Program::animationReady(QString path)
+{
+    if (path != m_animation_path)
+        return;
+
+    m_animation_frame = -1;
+    animationTimeout();
+}
+
+void Program::showWaveform(const QString &path)
+{
+    m_waveform_path = path;
+    Waveform l_waveform;
+    if (!path.isEmpty() && m_waveform_cache->find(path, &l_waveform)) {
+        m_waveform->setWaveform(l_waveform);
+        return;
+    }
+
+    m_waveform->clear();
+    if (!path.isEmpty())
+        m_waveform_cache->request(path);
+}
+
+void Program::waveformReady(QString path)
+{
+    Waveform l_waveform;
+    if (path == m_waveform_path && m_waveform_cache->find(path, &l_waveform))
+        m_waveform->setWaveform(l_waveform);
+}
+
+void Program::animationTimeout()
+{
+    const Animation *l_animation = m_animation_cache->find(m_animation_path);
+    if (l_animation == nullptr)
+        return;
+
+    m_animation_frame = (m_animation_frame + 1) % l_animation->frames.size();
+    ui->animbgLabel->setPixmap(l_animation->frames[m_animation_frame]);
+    if (l_animation->frames.size() > 1)
+        m_animation_timer.start(l_animation->delays[m_animation_frame]);
+}
+
+void Program::clearConfigButtonPressed()
+{
+    getCurrentTree()->clear();
+}
+
+void Program::createConfigButtonPressed()
+{
+    if (m_base_folder.isEmpty())
+        return;
+
+    getCurrentTree()->clear();
+    if (getCurrentTree() == m_workspace->configs["/music.json"])
+        m_workspace->music_length.clear(); // Ids start from 1 again
+
+    QDir l_dir(m_base_folder + getCurrentFolder());
+    QStringList l_items = l_dir.entryList();
+    if (getCurrentTree() == m_workspace->configs["/music.json"])
+        for (const QString &l_item_name : qAsConst(l_items)) {
+            QString l_name = l_item_name.left(l_item_name.lastIndexOf("."));
+            l_name = l_name.right(l_name.length() - (l_name.lastIndexOf("/") + 1));
+            if (l_name == l_item_name)
+                m_workspace->music_length.append("category");
+            else
+                m_workspace->music_length.append("0");
+        }
+
+    addItems(l_items, getCurrentTree(), ui->configList->currentIndex() < 2 ? m_item_flags : m_category_flags);
+}
+
+void Program::musicTxtToJsonButtonPressed()
+{
+    QVector<ConfigEntry> l_entries = configEntries("/music.txt");
+    if (l_entries.isEmpty())
+        return;
+
+    for (ConfigEntry &l_entry : l_entries)
+        l_entry.length = ConfigFile::isCategory(l_entry.name) ? "category" : "0";
+
+    setConfigEntries("/music.json", l_entries);
+}
+
+void Program::musicJsonToTxtButtonPressed()
+{
+    QVector<ConfigEntry> l_entries = configEntries("/music.json");
+    if (l_entries.isEmpty())
+        return;
+
+    for (ConfigEntry &l_entry : l_entries)
+        l_entry.length.clear();
+
+    setConfigEntries("/music.txt", l_entries);
+}
+
+void Program::getLengthButtonPressed()
+{
+    if (ui->configList->currentIndex() != 3)
+        return;
+
+    if (m_base_folder.isEmpty()) {
+        QMessageBox::information(this, tr("Warning!"), tr("Without the base folder, this function is not available!"));
+        return;
+    }
+
+    QList<QTreeWidgetItem *> l_items = m_workspace->configs["/music.json"]->selectedItems();
+    for (const QTreeWidgetItem *l_item : qAsConst(l_items)) {
+        int l_id = l_item->text(0).toInt() - 1;
+        if (m_workspace->music_length[l_id] != "category") {
+            m_workspace->music_length[l_id] = QString::number(probeLength(l_item->text(1)));
+            journalLength(m_workspace, l_id + 1);
+        }
+    }
+
+    QTreeWidgetItem *l_current = m_workspace->configs["/music.json"]->currentItem();
+    if (l_current != nullptr)
+        ui->lengthLine->setText(m_workspace->music_length[l_current->text(0).toInt() - 1]);
+}
+
+void Program::getLengthsButtonPressed()
+{
+    if (ui->configList->currentIndex() != 3)
+        return;
+
+    if (m_base_folder.isEmpty()) {
+        QMessageBox::information(this, tr("Warning!"), tr("Without the base folder, this function is not available!"));
+        return;
+    }
+
+    forEachEntry(m_workspace->configs["/music.json"], [this](int id, const QString &name) {
+        if (m_workspace->music_length[id - 1] == "0")
+            requestLength(m_workspace, id, name);
+    });
+
+    if (m_length_prober.pending() > 0)
+        ui->statusbar->showMessage(tr("Probing lengths... %1 left").arg(m_length_prober.pending()));
+}
+
+void Program::requestLength(Workspace *workspace, int id, const QString &name)
+{
+    QString l_path = m_base_folder + "/sounds/music/" + name;
+    if (!m_length_requests.contains(l_path))
+        m_length_prober.probe(l_path);
+    m_length_requests.insert(l_path, qMakePair(workspace, id));
+}
+
+void Program::lengthProbed(QString path, double length)
+{
+    const QList<QPair<Workspace *, int>> l_requests = m_length_requests.values(path);
+    m_length_requests.remove(path);
+    for (const QPair<Workspace *, int> &l_request : l_requests) {
+        QStringList &l_lengths = l_request.first->music_length;
+        if (l_request.second <= l_lengths.size() && l_lengths[l_request.second - 1] == "0") {
+            l_lengths[l_request.second - 1] = QString::number(length);
+            journalLength(l_request.first, l_request.second);
+        }
+    }
+
+    if (m_length_prober.pending() > 0)
+        ui->statusbar->showMessage(tr("Probing lengths... %1 left").arg(m_length_prober.pending()));
+    else
+        ui->statusbar->showMessage(tr("All lengths are probed"), 3000);
+}
+
+double Program::probeLength(const QString &name)
+{
+    QString l_path = m_base_folder + "/sounds/music/" + name;
+    AssetInfo l_info = m_asset_index.info("sounds/music/" + name);
+    if (!l_info.isValid()) { // The base folder is still indexing
+        QFileInfo l_file(l_path);
+        l_info.size = l_file.size();
+        l_info.modified = l_file.lastModified().toMSecsSinceEpoch();
+    }
+
+    double l_length;
+    if (!m_duration_cache.find(l_path, l_info.size, l_info.modified, &l_length)) {
+        l_length = LengthProber::length(l_path);
+        if (l_length > 0)
+            m_duration_cache.insert(l_path, l_info.size, l_info.modified, l_length);
+    }
+
+    return l_length;
+}
+
+void Program::playButtonPressed()
+{
+    if (!openChannel())
+        return;
+
+    // Songs that played to the end start over
+    bool l_ended = BASS_ChannelGetPosition(m_channel, BASS_POS_BYTE) >= BASS_ChannelGetLength(m_channel, BASS_POS_BYTE);
+    BASS_ChannelPlay(m_channel, l_ended);
+    m_position_timer.start();
+}
+
+void Program::stopButtonPressed()
+{
+    if (m_channel == 0)
+        return;
+
+    BASS_ChannelStop(m_channel);
+    BASS_ChannelSetPosition(m_channel, 0, BASS_POS_BYTE);
+    positionTimeout();
+}
+
+bool Program::openChannel()
+{
+    if (m_channel_path.isEmpty() || !ensureAudio())
+        return false;
+
+    // Probing may switch this thread to the decoding device
+    BASS_SetDevice(m_audio_device);
+    if (m_channel != 0 && m_channel_path == m_channel_loaded)
+        return true;
+
+    BASS_StreamFree(m_channel);
+    m_loop_sync = 0;
+    m_channel = getMusic(m_channel_path);
+    m_channel_loaded = m_channel_path;
+    if (m_channel == 0)
+        return false;
+
+    BASS_ChannelSetAttribute(m_channel, BASS_ATTRIB_BUFFER, 0);
+    double l_length = BASS_ChannelBytes2Seconds(m_channel, BASS_ChannelGetLength(m_channel, BASS_POS_BYTE));
+    ui->positionSlider->setMaximum(int(qMax(l_length, 0.0) * 1000));
+    updateLoop();
+    return true;
+}
+
+void Program::seekTo(double position)
+{
+    if (!openChannel())
+        return;
+
+    BASS_ChannelSetPosition(m_channel, BASS_ChannelSeconds2Bytes(m_channel, qMax(position, 0.0)), BASS_POS_BYTE);
+    positionTimeout();
+}
+
+void Program::positionTimeout()
+{
+    bool l_playing = m_channel != 0 && BASS_ChannelIsActive(m_channel) == BASS_ACTIVE_PLAYING;
+    if (!l_playing)
+        m_position_timer.stop();
+    if (m_channel == 0)
+        return;
+
+    double l_position = BASS_ChannelBytes2Seconds(m_channel, BASS_ChannelGetPosition(m_channel, BASS_POS_BYTE));
+    double l_length = BASS_ChannelBytes2Seconds(m_channel, BASS_ChannelGetLength(m_channel, BASS_POS_BYTE));
+    auto l_time = [](double seconds) { return QString("%1:%2").arg(int(seconds) / 60).arg(int(seconds) % 60, 2, 10, QChar('0')); };
+    ui->positionLabel->setText(l_time(l_position) + " / " + l_time(l_length));
+    if (!ui->positionSlider->isSliderDown())
+        ui->positionSlider->setValue(int(l_position * 1000));
+    if (m_channel_loaded == m_waveform_path)
+        m_waveform->setPosition(l_position);
+}
+
+void Program::loopToggled(bool checked)
+{
+    updateLoop();
+    if (!checked || !openChannel())
+        return;
+
+    // Audition the loop point right away instead of waiting for the loop end
+    double l_begin, l_end;
+    m_waveform->loop(&l_begin, &l_end);
+    if (m_channel_loaded != m_waveform_path || l_end <= l_begin)
+        l_end = BASS_ChannelBytes2Seconds(m_channel, BASS_ChannelGetLength(m_channel, BASS_POS_BYTE));
+    seekTo(qMax(l_begin, l_end - LOOP_LEAD));
+    playButtonPressed();
+}
+
+void Program::updateLoop()
+{
+    if (m_channel == 0)
+        return;
+
+    if (m_loop_sync != 0) {
+        BASS_ChannelRemoveSync(m_channel, m_loop_sync);
+        m_loop_sync = 0;
+    }
+    if (!ui->loopButton->isChecked())
+        return;
+
+    // The selection is of the shown waveform, another playing song loops whole
+    double l_begin = 0, l_end = 0;
+    if (m_channel_loaded == m_waveform_path)
+        m_waveform->loop(&l_begin, &l_end);
+
+    QWORD l_length = BASS_ChannelGetLength(m_channel, BASS_POS_BYTE);
+    QWORD l_end_bytes = l_end > l_begin ? BASS_ChannelSeconds2Bytes(m_channel, l_end) : l_length;
+    m_loop_start.store(l_end > l_begin ? BASS_ChannelSeconds2Bytes(m_channel, l_begin) : 0);
+    if (l_end_bytes >= l_length)
+        m_loop_sync = BASS_ChannelSetSync(m_channel, BASS_SYNC_END | BASS_SYNC_MIXTIME, 0, &Program::loopSync, this);
+    else
+        m_loop_sync = BASS_ChannelSetSync(m_channel, BASS_SYNC_POS | BASS_SYNC_MIXTIME, l_end_bytes, &Program::loopSync, this);
+}
+
+void CALLBACK Program::loopSync(HSYNC handle, DWORD channel, DWORD data, void *user)
+{
+    Q_UNUSED(handle);
+    Q_UNUSED(data);
+    BASS_ChannelSetPosition(channel, static_cast<Program *>(user)->m_loop_start.load(), BASS_POS_BYTE);
+}
+
+bool Program::ensureAudio()
+{
+    if (m_audio_device >= 0)
+        return true;
+
+    if (!BASS_Init(-1, 48000, BASS_DEVICE_LATENCY, 0, 0) && BASS_ErrorGetCode() != BASS_ERROR_ALREADY) {
+        ui->statusbar->showMessage(tr("Can't open the audio device (error %1)").arg(BASS_ErrorGetCode()), 5000);
+        return false;
+    }
+
+    m_audio_device = BASS_GetDevice();
+    return true;
+}
+
+void Program::addCategoryButtonPressed()
+{
+    int l_index = ui->configList->currentIndex();
+    if (l_index != 2 && l_index != 3)
+        return;
+    int l_id = lastId(getCurrentTree()) + 1;
+    QStringList l_category("New Category");
+    addItems(l_category, getCurrentTree(), m_category_flags);
+    if (l_index == 3)
+        setMusicLength(m_workspace, l_id, "category");
+}
+
+void Program::deleteButtonPressed()
+{
+    QList<QTreeWidgetItem *> l_items = getCurrentTree()->selectedItems();
+
+    // Areas and other configs keep referencing deleted assets, so ask first
+    QString l_key = m_workspace->configs.key(getCurrentTree());
+    QStringList l_used;
+    for (const QTreeWidgetItem *l_item : qAsConst(l_items)) {
+        QStringList l_places = describeUses(assetUses(m_workspace, l_item->text(1)), l_key);
+        if (!l_places.isEmpty())
+            l_used.append(l_item->text(1) + ": " + l_places.join(", "));
+    }
+    if (!l_used.isEmpty()) {
+        QString l_list = l_used.mid(0, 10).join("\n") + (l_used.size() > 10 ? "\n..." : "");
+        if (QMessageBox::question(this, tr("Delete"), tr("%1 of the selected items are still used:\n%2\nDelete them anyway?").arg(l_used.size()).arg(l_list)) != QMessageBox::Yes)
+            return;
+    }
+
+    QTreeWidget *l_tree = getCurrentTree();
+    QMap<int, QVector<int>> l_rows = EntryBatch::selectedRows(l_tree);
+
+    // Lengths are kept by id, and the greatest id is handed out again once its song is gone
+    if (ConfigFile::hasLengths(l_key)) {
+        for (auto it = l_rows.cbegin(); it != l_rows.cend(); ++it) {
+            QTreeWidgetItem *l_parent = EntryBatch::parentItem(l_tree, it.key());
+            for (int l_row : it.value())
+                forEachEntry(l_parent->child(l_row), [this](int id, const QString &) {
+                    if (id <= m_workspace->music_length.size())
+                        m_workspace->music_length[id - 1] = "0";
+                });
+        }
+    }
+
+    // Songs of categories go first, deleting top-level rows would move their categories
+    for (auto it = l_rows.cend(); it != l_rows.cbegin();) {
+        --it;
+        EntryBatch::removeRows(l_tree, it.key(), it.value());
+    }
+}
+
+void Program::moveToCategoryClicked()
+{
+    QTreeWidget *l_tree = getCurrentTree();
+    if (!ConfigFile::hasCategories(m_workspace->configs.key(l_tree)))
+        return;
+
+    QStringList l_names;
+    QVector<int> l_categories;
+    for (int i = 0; i < l_tree->topLevelItemCount(); i++) {
+        if (ConfigFile::isCategory(l_tree->topLevelItem(i)->text(1))) {
+            l_names.append(QString("%1: %2").arg(l_tree->topLevelItem(i)->text(0), l_tree->topLevelItem(i)->text(1)));
+            l_categories.append(i);
+        }
+    }
+    if (l_categories.isEmpty()) {
+        QMessageBox::information(this, tr("Warning!"), tr("There are no categories in the config!"));
+        return;
+    }
+
+    bool l_ok;
+    QString l_name = QInputDialog::getItem(this, tr("Move to category"), tr("Category:"), l_names, 0, false, &l_ok);
+    if (!l_ok)
+        return;
+    int l_target_row = l_categories[l_names.indexOf(l_name)];
+    QTreeWidgetItem *l_target = l_tree->topLevelItem(l_target_row);
+
+    // Categories stay where they are, and songs of the target category are already there
+    QMap<int, QVector<int>> l_rows = EntryBatch::selectedRows(l_tree);
+    l_rows.remove(l_target_row);
+    QVector<int> &l_top_rows = l_rows[-1];
+    for (int i = l_top_rows.size() - 1; i >= 0; i--)
+        if (ConfigFile::isCategory(l_tree->topLevelItem(l_top_rows[i])->text(1)))
+            l_top_rows.remove(i);
+
+    // Moved songs keep their order in the list, songs of a category come after it and before the next top-level row
+    QVector<QPair<QPair<int, int>, QTreeWidgetItem *>> l_order;
+    for (auto it = l_rows.cbegin(); it != l_rows.cend(); ++it) {
+        QTreeWidgetItem *l_parent = EntryBatch::parentItem(l_tree, it.key());
+        for (int l_row : it.value())
+            l_order.append(qMakePair(it.key() < 0 ? qMakePair(l_row, -1) : qMakePair(it.key(), l_row), l_parent->child(l_row)));
+    }
+    std::sort(l_order.begin(), l_order.end());
+
+    for (auto it = l_rows.cend(); it != l_rows.cbegin();) {
+        --it;
+        EntryBatch::takeRows(l_tree, it.key(), it.value());
+    }
+
+    QList<QTreeWidgetItem *> l_items;
+    l_items.reserve(l_order.size());
+    for (const auto &l_entry : qAsConst(l_order))
+        l_items.append(l_entry.second);
+    l_target->addChildren(l_items); // Songs of a collapsed category are put before them when it's expanded
+    ui->statusbar->showMessage(tr("Moved %1 songs to %2").arg(l_items.size()).arg(l_target->text(1)), 5000);
+}
+
+void Program::duplicateClicked()
+{
+    QTreeWidget *l_tree = getCurrentTree();
+    QString l_key = m_workspace->configs.key(l_tree);
+    bool l_categories = ConfigFile::hasCategories(l_key);
+    bool l_lengths = ConfigFile::hasLengths(l_key);
+    QMap<int, QVector<int>> l_rows = EntryBatch::selectedRows(l_tree);
+
+    int l_id = lastId(l_tree);
+    int l_count = 0;
+    for (auto it = l_rows.cend(); it != l_rows.cbegin();) {
+        --it;
+        QTreeWidgetItem *l_parent = EntryBatch::parentItem(l_tree, it.key());
+        QVector<int> l_copied_rows;
+        QList<QTreeWidgetItem *> l_copies;
+        for (int l_row : it.value()) {
+            QTreeWidgetItem *l_item = l_parent->child(l_row);
+            if (l_categories && it.key() < 0 && ConfigFile::isCategory(l_item->text(1))) // A copy would need copies of all its songs
+                continue;
+
+            QTreeWidgetItem *l_copy = l_item->clone();
+            l_copy->setData(0, Qt::DisplayRole, ++l_id);
+            if (l_lengths)
+                setMusicLength(m_workspace, l_id, m_workspace->music_length.value(l_item->text(0).toInt() - 1, "0"));
+            l_copied_rows.append(l_row);
+            l_copies.append(l_copy);
+        }
+
+        EntryBatch::insertAfterRows(l_tree, it.key(), l_copied_rows, l_copies);
+        l_count += l_copies.size();
+    }
+
+    ui->statusbar->showMessage(tr("Duplicated %1 items").arg(l_count), 5000);
+}
+
+void Program::setLengthClicked()
+{
+    QTreeWidget *l_tree = getCurrentTree();
+    QList<QTreeWidgetItem *> l_items = l_tree->selectedItems();
+    if (!ConfigFile::hasLengths(m_workspace->configs.key(l_tree)) || l_items.isEmpty())
+        return;
+
+    bool l_ok;
+    double l_length = QInputDialog::getDouble(this, tr("Set length"), tr("Length of %1 selected songs in seconds:").arg(l_items.size()), 0, 0, 86400, 3, &l_ok);
+    if (!l_ok)
+        return;
+
+    QString l_text = QString::number(l_length);
+    for (const QTreeWidgetItem *l_item : qAsConst(l_items)) {
+        int l_id = l_item->text(0).toInt();
+        if (m_workspace->music_length.value(l_id - 1) == "category")
+            continue;
+        setMusicLength(m_workspace, l_id, l_text);
+        journalLength(m_workspace, l_id);
+    }
+
+    QTreeWidgetItem *l_current = l_tree->currentItem();
+    if (l_current != nullptr)
+        ui->lengthLine->setText(m_workspace->music_length.value(l_current->text(0).toInt() - 1));
+}
+
+void Program::lengthEditingFinished()
+{
+    if (ui->configList->currentIndex() != 3)
+        return;
+
+    bool l_ok;
+    double l_new_length = ui->lengthLine->text().toDouble(&l_ok);
+    int l_id = getCurrentTree()->currentItem()->text(0).toInt() - 1;
+    if (!l_ok || m_workspace->music_length[l_id] == "category") {
+        ui->lengthLine->setText(m_workspace->music_length[l_id]);
+        return;
+    }
+
+    m_workspace->music_length[l_id] = QString::number(l_new_length);
+    journalLength(m_workspace, l_id + 1);
+}
+
+void Program::searchTextChanged(QString text)
+{
+    QTreeWidget *l_tree = getCurrentTree();
+    int l_mode = ui->filterModeBox->currentIndex();
+    QSet<int> l_ids;
+    if (text != "") {
+        QRegularExpression l_pattern;
+        if (l_mode != 0) {
+            l_pattern = m_pattern_cache.pattern(text, l_mode == 1 ? PatternCache::Glob : PatternCache::Regex);
+            if (!l_pattern.isValid()) {
+                ui->statusbar->showMessage(l_pattern.errorString(), 3000);
+                return;
+            }
+        }
+
+        l_ids = matchingEntries(l_tree, text, l_pattern);
+
+        // Create songs of collapsed categories that have matches
+        for (int i = 0; i < l_tree->topLevelItemCount(); i++) {
+            QTreeWidgetItem *l_item = l_tree->topLevelItem(i);
+            const QVector<int> l_children = pendingChildren(l_item).ids;
+            for (int l_id : l_children)
+                if (l_ids.contains(l_id)) {
+                    materializeChildren(l_item);
+                    break;
+                }
+        }
+    }
+
+    // Pattern matches become the selection to act on
+    if (l_mode != 0)
+        l_tree->clearSelection();
+
+    QTreeWidgetItemIterator l_iter(l_tree);
+    while (*l_iter) {
+        bool l_match = l_ids.contains((*l_iter)->text(0).toInt());
+        (*l_iter)->setHidden(text != "" && !l_match);
+        if (l_match) {
+            if ((*l_iter)->parent() != nullptr)
+                (*l_iter)->parent()->setHidden(false);
+            if (l_mode != 0)
+                (*l_iter)->setSelected(true);
+        }
+        ++l_iter;
+    }
+
+    if (l_mode != 0 && text != "")
+        ui->statusbar->showMessage(tr("%1 items selected").arg(l_ids.size()), 3000);
+}
+
+QSet<int> Program::matchingEntries(QTreeWidget *widget, const QString &text, const QRegularExpression &pattern)
+{
+    // Names of collapsed songs stay in the pool and are built by the workers, one buffer per chunk
+    QVector<int> l_ids;
+    QStringList l_names;
+    QVector<int> l_pooled;
+    QTreeWidgetItemIterator l_iter(widget);
+    while (*l_iter) {
+        l_ids.append((*l_iter)->text(0).toInt());
+        l_names.append((*l_iter)->text(1));
+        l_pooled.append(-1);
+
+        const PendingChildren l_children = pendingChildren(*l_iter);
+        l_ids += l_children.ids;
+        l_pooled += l_children.names;
+        for (int i = 0; i < l_children.names.size(); i++)
+            l_names.append(QString());
+        ++l_iter;
+    }
+
+    struct Chunk
+    {
+        int begin;
+        int end;
+        QVector<int> matches;
+    };
+
+    QVector<Chunk> l_chunks;
+    for (int i = 0; i < l_names.size(); i += 4096)
+        l_chunks.append(Chunk{i, qMin(i + 4096, l_names.size()), QVector<int>()});
+
+    bool l_contains = pattern.pattern().isEmpty();
+    const StringPool &l_pool = m_string_pool;
+    QtConcurrent::blockingMap(l_chunks, [&l_ids, &l_names, &l_pooled, &l_pool, &text, &pattern, l_contains](Chunk &chunk) {
+        QRegularExpression l_pattern = pattern;
+        QString l_buffer;
+        for (int i = chunk.begin; i < chunk.end; i++) {
+            if (l_pooled[i] >= 0)
+                l_pool.name(l_pooled[i], &l_buffer);
+            const QString &l_name = l_pooled[i] >= 0 ? l_buffer : l_names[i];
+            if (l_contains ? l_name.contains(text, Qt::CaseInsensitive) : l_pattern.match(l_name).hasMatch())
+                chunk.matches.append(l_ids[i]);
+        }
+    });
+
+    QSet<int> l_matches;
+    for (const Chunk &l_chunk : qAsConst(l_chunks))
+        for (int l_id : l_chunk.matches)
+            l_matches.insert(l_id);
+
+    return l_matches;
+}
+
+void Program::onItemClicked(QTreeWidgetItem *item)
+{
+    if (ui->configList->currentIndex() == 3) {
+        int l_id = item->text(0).toInt();
+        if (l_id <= m_workspace->music_length.size())
+            ui->lengthLine->setText(m_workspace->music_length[l_id - 1]);
+    }
+
+    QStringList l_places = describeUses(assetUses(m_workspace, item->text(1)), m_workspace->configs.key(getCurrentTree()));
+    if (!l_places.isEmpty())
+        ui->statusbar->showMessage(tr("Used by %1").arg(l_places.join(", ")));
+    else
+        ui->statusbar->clearMessage();
+
+    if (m_base_folder.isEmpty())
+        return;
+
+    ui->animbgList->clear();
+    ui->chariconLabel->clear();
+    QString l_dir = m_base_folder + getCurrentFolder() + getCurrentTree()->currentItem()->text(1);
+
+    switch (ui->configList->currentIndex()) {
+    case 0:
+    case 1:
+    {
+        l_dir = l_dir + "/";
+        QDirIterator l_files(l_dir, QDir::Files, QDirIterator::Subdirectories);
+
+        while (l_files.hasNext()) {
+            QString l_file = l_files.next().remove(l_dir);
+            if (l_file.startsWith("char_icon"))
+                ui->chariconLabel->setPixmap(QPixmap(l_dir + l_file).scaled(80, 80));
+            else if (l_file.startsWith("emotions"))
+                continue;
+            else if (l_file.endsWith(".png") || l_file.endsWith(".webp") || l_file.endsWith(".gif") || l_file.endsWith(".apng"))
+                ui->animbgList->addItem(l_file);
+        }
+
+        break;
+    }
+    case 2:
+    case 3:
+    {
+        m_channel_path = l_dir; // Opened when it's played
+        showWaveform(ConfigFile::isCategory(item->text(1)) ? QString() : l_dir);
+        break;
+    }
+    default:
+        break;
+    }
 
-                l_array = l_object["songs"].toArray();
-                for (int i = 0; i < l_array.size(); i++) {
-                    QJsonObject l_music_object = l_array.at(i).toObject();
-                    l_items.append(l_music_object["name"].toString());
-                    m_music_length.append(QString::number(l_music_object["length"].toVariant().toDouble()));
-                }
-            }
-        }
+    qDebug() << "Selected file's path is " + l_dir;
+}
 
-        QString l_suc = l_file.isReadable() ? "Success!" : "Failure!"; // I think it that works
-        qDebug() << "Loading " + l_key + "... " + l_suc;
-        l_file.close();
-        addItems(l_items, m_configs[l_key], l_flags);
-        l_items.clear();
+void Program::onItemDoubleClicked(QTreeWidgetItem *item, int column)
+{
+    if (column == 1) {
+        m_edited_item = item;
+        m_edited_name = item->text(1);
+        getCurrentTree()->editItem(item, column);
     }
 }
 
-void Program::openBaseFolderClicked()
+void Program::quickOpenClicked()
 {
-    m_base_folder = QFileDialog::getExistingDirectory();
-    qDebug() << "Base folder's path is: " + m_base_folder;
+    QVector<FinderEntry> l_entries;
+    QStringList l_keys = m_workspace->configs.keys();
+    for (const QString &l_key : qAsConst(l_keys))
+        forEachEntry(m_workspace->configs[l_key], [&l_entries, &l_key](int id, const QString &name) {
+            l_entries.append(FinderEntry{name, l_key, id});
+        });
+    m_finder.setEntries(l_entries);
+
+    QuickOpenDialog l_dialog(&m_finder, this);
+    if (l_dialog.exec() != QDialog::Accepted || l_dialog.selectedIndex() < 0)
+        return;
+
+    const FinderEntry &l_entry = m_finder.entry(l_dialog.selectedIndex());
+    selectEntry(l_entry.config, l_entry.id);
 }
 
-void Program::saveButtonPressed()
+void Program::bulkRenameClicked()
 {
-    if (m_config_folder.isEmpty())
-        m_config_folder = QFileDialog::getExistingDirectory(); // Get directory to save created from scratch configs
+    QTreeWidget *l_tree = getCurrentTree();
+    QVector<int> l_ids;
+    QStringList l_names;
+    QList<QTreeWidgetItem *> l_items = l_tree->selectedItems();
+    if (!l_items.isEmpty())
+        for (const QTreeWidgetItem *l_item : qAsConst(l_items)) {
+            l_ids.append(l_item->text(0).toInt());
+            l_names.append(l_item->text(1));
+        }
+    else if (ui->searchLine->text().isEmpty())
+        forEachEntry(l_tree, [&l_ids, &l_names](int id, const QString &name) {
+            l_ids.append(id);
+            l_names.append(name);
+        });
+    else { // Items shown by the search
+        QTreeWidgetItemIterator l_iter(l_tree, QTreeWidgetItemIterator::NotHidden);
+        while (*l_iter) {
+            l_ids.append((*l_iter)->text(0).toInt());
+            l_names.append((*l_iter)->text(1));
+            ++l_iter;
+        }
+    }
 
-    QStringList l_keys = m_configs.keys();
-    for (const QString &l_key : qAsConst(l_keys)) {
-        QList<QTreeWidgetItem *> l_items = m_configs[l_key]->findItems(
-            QString("*"), Qt::MatchWrap | Qt::MatchWildcard | Qt::MatchRecursive);
-        if (l_items.isEmpty())
-            continue;
+    if (l_ids.isEmpty())
+        return;
 
-        QFile l_file;
-        l_file.setFileName(m_config_folder + l_key);
-        l_file.open(QIODevice::WriteOnly);
-        l_file.resize(0);
-        QTextStream out(&l_file);
-        if (l_key != l_keys[2]) // Save backgrounds.txt, characters.txt, music.txt
-            for (const QTreeWidgetItem *l_item : qAsConst(l_items))
-#if QT_VERSION > QT_VERSION_CHECK(5, 14, 0)
-                out << l_item->text(1) << Qt::endl;
-#else
-                out << l_item->text(1) << endl;
-#endif
-        else { // Save music.json
-            QJsonDocument l_json;
-            QJsonObject l_record_object;
-            QJsonArray l_category_array;
-            QJsonArray l_record_array;
-            QString l_last_category;
-            for (const QTreeWidgetItem *l_item : qAsConst(l_items)) {
-                QString l_name = l_item->text(1);
-                QString l_music_name = l_name.left(l_name.lastIndexOf("."));
-                l_music_name = l_music_name.right(l_music_name.length() - (l_music_name.lastIndexOf("/") + 1));
-                if (l_name == l_music_name && l_last_category != l_name) {
-                    if (!l_last_category.isEmpty()) {
-                        l_record_array.push_back(l_record_object);
-                        l_category_array = QJsonArray();
-                    }
-
-                    l_record_object.insert("category", l_name);
-                    l_last_category = l_name;
-                }
-                else {
-                    QJsonObject l_music{{"name", l_name}, {"length", m_music_length[l_item->text(0).toInt() - 1]}};
-                    l_category_array.push_back(l_music);
-                    l_record_object.insert("songs", l_category_array);
-                }
+    // New names must not collide with items that aren't renamed either
+    QSet<int> l_renamed;
+    for (int l_id : qAsConst(l_ids))
+        l_renamed.insert(l_id);
+    QSet<QString> l_others;
+    forEachEntry(l_tree, [&l_renamed, &l_others](int id, const QString &name) {
+        if (!l_renamed.contains(id))
+            l_others.insert(name);
+    });
+
+    QString l_key = m_workspace->configs.key(l_tree);
+    BulkRenameDialog l_dialog(l_ids, l_names, l_others, &m_asset_index, getCurrentFolder().mid(1), ConfigFile::hasCategories(l_key), this);
+    if (l_dialog.exec() != QDialog::Accepted)
+        return;
 
-                if (l_item == l_items.last())
-                    l_record_array.push_back(l_record_object);
-            }
+    QVector<RenameChange> l_changes = l_dialog.changes();
+    if (!l_changes.isEmpty())
+        m_workspace->undo_stack->push(new RenameCommand(this, m_workspace, l_key, l_changes));
+}
 
-            l_json.setArray(l_record_array);
-            out << l_json.toJson();
+void Program::transcodeClicked()
+{
+    if (m_transcoder.isRunning()) {
+        if (QMessageBox::question(this, tr("Transcode"), tr("Cancel transcoding? Converted songs are kept.")) == QMessageBox::Yes) {
+            m_transcoder.cancel();
+            transcodeFinished();
         }
+        return;
+    }
 
-        QString l_suc = l_file.isWritable() ? "Success!" : "Failure!"; // I think it that works
-        qDebug() << "Saving " + l_key + "... " + l_suc;
-        l_file.close();
+    if (m_base_folder.isEmpty()) {
+        QMessageBox::information(this, tr("Warning!"), tr("Without the base folder, this function is not available!"));
+        return;
     }
-}
 
-void Program::aboutButtonClicked()
-{
-    QMessageBox::about(this, tr("About"), tr("<h2>Akashi Asset Config Editor</h2>"
-                                             "<p>Simple program for adding/deleting assets on the server.</p>"
-                                             "<p>Created by Ddedinya</p>"
-                                             "<p>Source code: <a href='https://github.com/Ddedinya/Akashi-Asset-Config-Editor'>https://github.com/Ddedinya/Akashi-Asset-Config-Editor</a></p>"
-                                             "<p>The program and the author have nothing to do with the Attorney Online 2 developers!</p>"));
+    QSettings l_settings;
+    bool l_ok;
+    QString l_command = QInputDialog::getText(this, tr("Transcode to Opus"), tr("Encoder command, {input} and {output} are replaced by paths of each song:"), QLineEdit::Normal,
+                                              l_settings.value("transcode_command", OpusTranscoder::DEFAULT_COMMAND).toString(), &l_ok);
+    if (!l_ok)
+        return;
+    if (!m_transcoder.setCommand(l_command)) {
+        QMessageBox::information(this, tr("Warning!"), tr("The command must have {input} and {output}!"));
+        return;
+    }
+    l_settings.setValue("transcode_command", l_command);
+
+    // Songs listed in both configs are converted once
+    QSet<QString> l_names;
+    for (const QString &l_key : {QString("/music.txt"), QString("/music.json")})
+        forEachEntry(m_workspace->configs[l_key], [&l_names](int, const QString &name) {
+            QString l_suffix = QFileInfo(name).suffix().toLower();
+            if (!ConfigFile::isCategory(name) && (l_suffix == "mp3" || l_suffix == "wav" || l_suffix == "ogg"))
+                l_names.insert(name);
+        });
+
+    // E.g. song.mp3 and song.ogg would both become song.opus, only the first one in order is converted
+    QStringList l_sorted = l_names.values();
+    std::sort(l_sorted.begin(), l_sorted.end());
+    QVector<TranscodeJob> l_jobs;
+    QHash<QString, QString> l_targets;
+    QStringList l_conflicts;
+    QString l_folder = m_base_folder + "/sounds/music/";
+    for (const QString &l_name : qAsConst(l_sorted)) {
+        QString l_target = l_name.left(l_name.lastIndexOf('.')) + ".opus";
+        TranscodeJob l_job{l_folder + l_name, l_folder + l_target};
+        if (!QFileInfo::exists(l_job.source) || QFileInfo::exists(l_job.target))
+            continue;
+        if (l_targets.contains(l_target.toLower())) {
+            l_conflicts.append(tr("%1 (%2 also becomes %3)").arg(l_name, l_targets[l_target.toLower()], l_target));
+            continue;
+        }
+        l_targets.insert(l_target.toLower(), l_name);
+        l_jobs.append(l_job);
+    }
+    if (l_jobs.isEmpty()) {
+        QMessageBox::information(this, tr("Transcode"), tr("There are no .mp3, .wav or .ogg songs without an .opus version."));
+        return;
+    }
+    if (!l_conflicts.isEmpty())
+        QMessageBox::information(this, tr("Transcode"), tr("%1 songs are skipped, another song is converted to the same file:\n%2").arg(l_conflicts.size()).arg(l_conflicts.mid(0, 10).join("\n") + (l_conflicts.size() > 10 ? "\n..." : "")));
+
+    m_transcode_workspace = m_workspace;
+    m_transcode_results.clear();
+    m_transcode_total = l_jobs.size();
+    ui->statusbar->showMessage(tr("Transcoding... 0/%1").arg(m_transcode_total));
+    m_transcoder.start(l_jobs);
 }
 
-void Program::animBgListChanged(QString filename)
+void Program::songTranscoded(TranscodeResult result)
 {
-    ui->animbgLabel->setPixmap(QPixmap(m_base_folder + getCurrentFolder() + getCurrentTree()->currentItem()->text(1) + "/" + filename).scaled(256, 192));
-}
+    m_transcode_results.append(result);
+    ui->statusbar->showMessage(tr("Transcoding... %1/%2").arg(m_transcode_results.size()).arg(m_transcode_total));
+    if (!result.ok)
+        return;
 
-void Program::clearConfigButtonPressed()
-{
-    getCurrentTree()->clear();
+    // The length doesn't change, so it's not probed again
+    QFileInfo l_source(result.job.source);
+    double l_length;
+    if (m_duration_cache.find(result.job.source, l_source.size(), l_source.lastModified().toMSecsSinceEpoch(), &l_length)) {
+        QFileInfo l_target(result.job.target);
+        m_duration_cache.insert(result.job.target, l_target.size(), l_target.lastModified().toMSecsSinceEpoch(), l_length);
+    }
 }
 
-void Program::createConfigButtonPressed()
+void Program::transcodeFinished()
 {
-    if (m_base_folder.isEmpty())
+    if (m_transcode_results.isEmpty())
         return;
 
-    getCurrentTree()->clear();
+    QHash<QString, QString> l_renames;
+    QStringList l_failures;
+    qint64 l_saved = 0;
+    int l_folder_length = (m_base_folder + "/sounds/music/").length();
+    for (const TranscodeResult &l_result : qAsConst(m_transcode_results)) {
+        if (!l_result.ok) {
+            l_failures.append(l_result.job.source.mid(l_folder_length) + ": " + l_result.error);
+            continue;
+        }
+        l_renames.insert(l_result.job.source.mid(l_folder_length), l_result.job.target.mid(l_folder_length));
+        l_saved += l_result.source_size - l_result.target_size;
+    }
 
-    QDir l_dir(m_base_folder + getCurrentFolder());
-    QStringList l_items = l_dir.entryList();
-    if (getCurrentTree() == ui->treemusicjson)
-        for (const QString &l_item_name : qAsConst(l_items)) {
-            QString l_name = l_item_name.left(l_item_name.lastIndexOf("."));
-            l_name = l_name.right(l_name.length() - (l_name.lastIndexOf("/") + 1));
-            if (l_name == l_item_name)
-                m_music_length.append("category");
-            else
-                m_music_length.append("0");
+    if (m_transcode_workspace != nullptr && !l_renames.isEmpty()) { // Null if the workspace was closed meanwhile
+        m_transcode_workspace->undo_stack->beginMacro(tr("Transcode to Opus"));
+        for (const QString &l_key : {QString("/music.txt"), QString("/music.json")}) {
+            QVector<RenameChange> l_changes;
+            forEachEntry(m_transcode_workspace->configs[l_key], [&l_changes, &l_renames](int id, const QString &name) {
+                auto l_rename = l_renames.constFind(name);
+                if (l_rename != l_renames.constEnd())
+                    l_changes.append(RenameChange{id, name, l_rename.value()});
+            });
+            if (!l_changes.isEmpty())
+                m_transcode_workspace->undo_stack->push(new RenameCommand(this, m_transcode_workspace, l_key, l_changes));
         }
+        m_transcode_workspace->undo_stack->endMacro();
+    }
 
-    addItems(l_items, getCurrentTree(), m_item_flags);
+    int l_converted = m_transcode_results.size() - l_failures.size();
+    m_transcode_results.clear();
+    m_transcode_workspace = nullptr;
+    if (!m_asset_index.isEmpty())
+        scanBaseFolder();
+
+    ui->statusbar->clearMessage();
+    QString l_report = tr("Transcoded %1 of %2 songs, %3 saved. Originals are kept, Find unused assets can archive them.").arg(l_converted).arg(m_transcode_total).arg(UnusedAssetsDialog::formatSize(l_saved));
+    if (!l_failures.isEmpty())
+        l_report += "\n\n" + tr("Failed:\n%1").arg(l_failures.mid(0, 10).join("\n"));
+    QMessageBox::information(this, tr("Transcode"), l_report);
 }
 
-void Program::musicTxtToJsonButtonPressed()
+void Program::renameEntries(Workspace *workspace, const QString &key, const QVector<RenameChange> &changes, bool revert)
 {
-    QList<QTreeWidgetItem *> l_items = ui->treemusictxt->findItems(
-        QString("*"), Qt::MatchWrap | Qt::MatchWildcard | Qt::MatchRecursive);
-
-    if (l_items.isEmpty())
-        return;
+    QHash<int, int> l_changes;
+    l_changes.reserve(changes.size());
+    for (int i = 0; i < changes.size(); i++)
+        l_changes.insert(changes[i].id, i);
+
+    // Items whose name was changed after the rename are left alone
+    m_journal_paused++;
+    int l_renamed = 0;
+    QVector<int> l_ids;
+    QStringList l_old_names;
+    QStringList l_new_names;
+    QTreeWidgetItemIterator l_iter(workspace->configs[key]);
+    while (*l_iter) {
+        QTreeWidgetItem *l_item = *l_iter;
+        auto l_change = l_changes.constFind(l_item->text(0).toInt());
+        if (l_change != l_changes.constEnd()) {
+            const RenameChange &l_rename = changes[l_change.value()];
+            if (l_item->text(1) == (revert ? l_rename.new_name : l_rename.old_name)) {
+                l_ids.append(l_rename.id);
+                l_old_names.append(l_item->text(1));
+                l_item->setText(1, revert ? l_rename.old_name : l_rename.new_name);
+                l_new_names.append(l_item->text(1));
+                l_renamed++;
+            }
+        }
 
-    ui->treemusicjson->clear();
-    m_music_length.clear();
+        PendingChildren l_children = pendingChildren(l_item);
+        bool l_changed = false;
+        for (int i = 0; i < l_children.ids.size(); i++) {
+            l_change = l_changes.constFind(l_children.ids[i]);
+            if (l_change == l_changes.constEnd())
+                continue;
 
-    QStringList l_items_name;
+            const RenameChange &l_rename = changes[l_change.value()];
+            if (m_string_pool.equals(l_children.names[i], revert ? l_rename.new_name : l_rename.old_name)) {
+                l_ids.append(l_rename.id);
+                l_old_names.append(revert ? l_rename.new_name : l_rename.old_name);
+                l_new_names.append(revert ? l_rename.old_name : l_rename.new_name);
+                l_children.names[i] = m_string_pool.intern(revert ? l_rename.old_name : l_rename.new_name);
+                l_changed = true;
+                l_renamed++;
+            }
+        }
+        if (l_changed)
+            setPendingChildren(l_item, l_children);
 
-    for (const QTreeWidgetItem *l_item : qAsConst(l_items)) {
-        QString l_item_name = l_item->text(1);
-        QString l_name = l_item_name.left(l_item_name.lastIndexOf("."));
-        l_name = l_name.right(l_name.length() - (l_name.lastIndexOf("/") + 1));
-        if (l_name == l_item_name)
-            m_music_length.append("category");
-        else
-            m_music_length.append("0");
+        ++l_iter;
+    }
 
-        l_items_name.append(l_item_name);
+    m_journal_paused--;
+    workspace->usage.removeNames(key, l_old_names);
+    workspace->usage.addNames(key, l_new_names);
+    if (workspace->journal != nullptr && !l_ids.isEmpty()) {
+        for (int i = 0; i < l_ids.size(); i++)
+            workspace->journal->recordRename(key, l_ids[i], l_new_names[i]);
+        m_journal_timer.start(JOURNAL_DELAY);
     }
 
-    addItems(l_items_name, ui->treemusicjson, m_category_flags);
+    ui->statusbar->showMessage(tr("Renamed %1 items").arg(l_renamed), 3000);
 }
 
-void Program::musicJsonToTxtButtonPressed()
+void Program::sortClicked(EntrySorter::Criterion criterion)
 {
-    QList<QTreeWidgetItem *> l_items = ui->treemusicjson->findItems(
-        QString("*"), Qt::MatchWrap | Qt::MatchWildcard | Qt::MatchRecursive);
-    if (l_items.isEmpty())
+    QTreeWidget *l_tree = getCurrentTree();
+    QString l_key = m_workspace->configs.key(l_tree);
+    if (criterion == EntrySorter::Length && !ConfigFile::hasLengths(l_key)) {
+        QMessageBox::information(this, tr("Warning!"), tr("Only music.json has lengths!"));
+        return;
+    }
+
+    if (criterion == EntrySorter::Size && m_asset_index.isEmpty()) {
+        QMessageBox::information(this, tr("Warning!"), tr("Without the indexed base folder, this function is not available!"));
         return;
+    }
+
+    QElapsedTimer l_timer;
+    l_timer.start();
+
+    // Sort songs of selected categories or the whole config
+    QList<QTreeWidgetItem *> l_categories;
+    QList<QTreeWidgetItem *> l_selected = l_tree->selectedItems();
+    for (QTreeWidgetItem *l_item : qAsConst(l_selected))
+        if (l_item->parent() == nullptr && (l_item->childCount() > 0 || !pendingChildren(l_item).ids.isEmpty()))
+            l_categories.append(l_item);
+
+    if (l_categories.isEmpty()) {
+        // Categories stay in place, only items between them are sorted
+        QList<QTreeWidgetItem *> l_items = l_tree->invisibleRootItem()->takeChildren();
+        bool l_has_categories = ConfigFile::hasCategories(l_key);
+        QList<QTreeWidgetItem *> l_sorted;
+        l_sorted.reserve(l_items.size());
+        for (int l_begin = 0; l_begin < l_items.size();) {
+            if (l_has_categories && ConfigFile::isCategory(l_items[l_begin]->text(1))) {
+                l_categories.append(l_items[l_begin]);
+                l_sorted.append(l_items[l_begin++]);
+                continue;
+            }
 
-    ui->treemusictxt->clear();
+            int l_end = l_begin;
+            while (l_end < l_items.size() && !(l_has_categories && ConfigFile::isCategory(l_items[l_end]->text(1))))
+                l_end++;
+            l_sorted.append(sortItems(l_items.mid(l_begin, l_end - l_begin), criterion));
+            l_begin = l_end;
+        }
+        l_tree->addTopLevelItems(l_sorted);
+    }
+
+    for (QTreeWidgetItem *l_category : qAsConst(l_categories)) {
+        PendingChildren l_children = pendingChildren(l_category);
+        if (!l_children.ids.isEmpty()) {
+            QStringList l_names;
+            l_names.reserve(l_children.names.size());
+            for (int l_name : qAsConst(l_children.names))
+                l_names.append(m_string_pool.name(l_name));
+            QVector<int> l_order = sortOrder(l_children.ids, l_names, criterion);
+            PendingChildren l_sorted;
+            l_sorted.ids.reserve(l_order.size());
+            l_sorted.names.reserve(l_order.size());
+            for (int l_index : qAsConst(l_order)) {
+                l_sorted.ids.append(l_children.ids[l_index]);
+                l_sorted.names.append(l_children.names[l_index]);
+            }
+            setPendingChildren(l_category, l_sorted);
+            journalReordered(m_workspace, l_key, l_category->text(0).toInt(), l_sorted);
+        }
 
-    QStringList l_items_name;
-    for (const QTreeWidgetItem *l_item : qAsConst(l_items))
-        l_items_name.append(l_item->text(1));
+        if (l_category->childCount() > 0)
+            l_category->insertChildren(0, sortItems(l_category->takeChildren(), criterion));
+    }
 
-    addItems(l_items_name, ui->treemusictxt, m_category_flags);
+    ui->statusbar->showMessage(tr("Sorted in %1 ms").arg(l_timer.elapsed()), 3000);
 }
 
-void Program::getLengthButtonPressed()
+QList<QTreeWidgetItem *> Program::sortItems(const QList<QTreeWidgetItem *> &items, EntrySorter::Criterion criterion)
 {
-    if (ui->configList->currentIndex() != 3)
-        return;
-
-    if (m_base_folder.isEmpty()) {
-        QMessageBox::information(this, tr("Warning!"), tr("Without the base folder, this function is not available!"));
-        return;
+    QVector<int> l_ids;
+    QStringList l_names;
+    l_ids.reserve(items.size());
+    l_names.reserve(items.size());
+    for (const QTreeWidgetItem *l_item : items) {
+        l_ids.append(l_item->text(0).toInt());
+        l_names.append(l_item->text(1));
     }
 
-    QList<QTreeWidgetItem *> l_items = ui->treemusicjson->selectedItems();
-    for (const QTreeWidgetItem *l_item : qAsConst(l_items)) {
-        int l_id = l_item->text(0).toInt() - 1;
+    QList<QTreeWidgetItem *> l_sorted;
+    l_sorted.reserve(items.size());
+    const QVector<int> l_order = sortOrder(l_ids, l_names, criterion);
+    for (int l_index : l_order)
+        l_sorted.append(items[l_index]);
 
-        if (m_music_length[l_id] == "category")
-            return;
+    return l_sorted;
+}
 
-        QString l_length = QString::number(BASS_ChannelBytes2Seconds(m_channel, BASS_ChannelGetLength(m_channel, BASS_POS_BYTE)));
-        m_music_length[l_id] = l_length;
+QVector<int> Program::sortOrder(const QVector<int> &ids, const QStringList &names, EntrySorter::Criterion criterion)
+{
+    QVector<SortKey> l_keys;
+    if (criterion == EntrySorter::Name)
+        l_keys = EntrySorter::nameKeys(names);
+    else {
+        l_keys.resize(ids.size());
+        QString l_folder = getCurrentFolder().mid(1);
+        QHash<QString, qint64> l_folder_sizes;
+        if (criterion == EntrySorter::Size && !l_folder.startsWith("sounds/")) // Backgrounds and characters are folders
+            l_folder_sizes = m_asset_index.folderSizes(l_folder);
+        for (int i = 0; i < ids.size(); i++) {
+            bool l_ok = true;
+            if (criterion == EntrySorter::Length)
+                l_keys[i].number = m_workspace->music_length.value(ids[i] - 1).toDouble(&l_ok);
+            else {
+                AssetInfo l_info = m_asset_index.info(l_folder + names[i]);
+                l_keys[i].number = l_info.is_dir ? l_folder_sizes.value(names[i]) : l_info.size;
+                l_ok = l_info.isValid();
+            }
+            l_keys[i].missing = !l_ok;
+        }
     }
 
-    ui->lengthLine->setText(m_music_length[ui->treemusicjson->currentItem()->text(0).toInt() - 1]);
+    return EntrySorter::order(l_keys, ui->actionSort_descending->isChecked());
 }
 
-void Program::getLengthsButtonPressed()
+void Program::selectEntry(const QString &key, int id)
 {
-    if (ui->configList->currentIndex() != 3)
-        return;
+    QTreeWidget *l_tree = m_workspace->configs[key];
+    ui->configList->setCurrentWidget(l_tree->parentWidget());
 
-    if (m_base_folder.isEmpty()) {
-        QMessageBox::information(this, tr("Warning!"), tr("Without the base folder, this function is not available!"));
+    QTreeWidgetItem *l_item = findEntry(l_tree, id);
+    if (l_item == nullptr)
         return;
-    }
 
-    QList<QTreeWidgetItem *> l_items = ui->treemusicjson->findItems(
-        QString("*"), Qt::MatchWrap | Qt::MatchWildcard | Qt::MatchRecursive);
-    for (const QTreeWidgetItem *l_item : qAsConst(l_items)) {
-        int l_id = l_item->text(0).toInt() - 1;
-        if (m_music_length[l_id] == "0") {
-            DWORD l_music = getMusic(m_base_folder + getCurrentFolder() + l_item->text(1));
-            m_music_length[l_id] = QString::number(BASS_ChannelBytes2Seconds(l_music, BASS_ChannelGetLength(l_music, BASS_POS_BYTE)));
-        }
+    l_item->setHidden(false);
+    if (l_item->parent() != nullptr) {
+        l_item->parent()->setHidden(false);
+        l_item->parent()->setExpanded(true);
     }
-}
 
-void Program::playButtonPressed()
-{
-    BASS_ChannelPlay(m_channel, true);
+    l_tree->setCurrentItem(l_item);
+    l_tree->scrollToItem(l_item);
+    onItemClicked(l_item);
 }
 
-void Program::stopButtonPressed()
+void Program::dragEnterEvent(QDragEnterEvent *event)
 {
-    BASS_ChannelStop(m_channel);
+    if (event->mimeData()->hasUrls()) {
+        event->acceptProposedAction();
+    }
 }
 
-void Program::addCategoryButtonPressed()
+void Program::dropEvent(QDropEvent *event)
 {
-    int l_index = ui->configList->currentIndex();
-    if (l_index != 2 && l_index != 3)
+    if (m_drop_watcher.isRunning() || !m_drop_items.isEmpty()) {
+        ui->statusbar->showMessage(tr("Still adding dropped items, try again later"), 3000);
         return;
-    if (l_index == 3)
-        m_music_length.append("category");
-
-    QStringList l_category("New Category");
-    addItems(l_category, getCurrentTree(), m_category_flags);
-}
+    }
 
-void Program::deleteButtonPressed()
-{
-    QList<QTreeWidgetItem *> l_items = getCurrentTree()->selectedItems();
-    for (int i = 0; i < l_items.size(); i++)
-        delete l_items[i];
+    QStringList l_paths;
+    const QList<QUrl> l_urls = event->mimeData()->urls();
+    for (const QUrl &l_url : l_urls)
+        if (l_url.isLocalFile())
+            l_paths.append(l_url.toLocalFile());
+
+    // Folders are scanned in background, items are added when scanning is finished
+    m_drop_workspace = m_workspace;
+    m_drop_key = m_workspace->configs.key(getCurrentTree());
+    QString l_folder = m_base_folder.isEmpty() ? QString() : m_base_folder + getCurrentFolder();
+    l_folder.chop(1);
+    if (ConfigFile::hasCategories(m_drop_key))
+        m_drop_watcher.setFuture(QtConcurrent::run([l_paths, l_folder] { return DropScanner::scanMusic(l_paths, l_folder); }));
+    else
+        m_drop_watcher.setFuture(QtConcurrent::run([l_paths, l_folder] { return DropScanner::scanFolders(l_paths, l_folder); }));
+    ui->statusbar->showMessage(tr("Scanning dropped files..."));
 }
 
-void Program::lengthEditingFinished()
+void Program::dropScanFinished()
 {
-    if (ui->configList->currentIndex() != 3)
-        return;
-
-    bool l_ok;
-    double l_new_length = ui->lengthLine->text().toDouble(&l_ok);
-    int l_id = getCurrentTree()->currentItem()->text(0).toInt() - 1;
-    if (!l_ok || m_music_length[l_id] == "category") {
-        ui->lengthLine->setText(m_music_length[l_id]);
+    if (m_drop_workspace == nullptr) // The workspace is closed
         return;
-    }
 
-    m_music_length[l_id] = QString::number(l_new_length);
+    m_drop_items = m_drop_watcher.result();
+    m_drop_count = 0;
+    m_drop_timer.start(0);
 }
 
-void Program::searchTextChanged(QString text)
+void Program::insertDropBatch()
 {
-    QTreeWidgetItemIterator l_iter(getCurrentTree());
-    while (*l_iter) {
-        (*l_iter)->setHidden(text != "");
-        ++l_iter;
+    if (m_drop_items.isEmpty()) {
+        m_drop_timer.stop();
+        ui->statusbar->showMessage(tr("Added %1 items").arg(m_drop_count), 3000);
+        return;
     }
 
-    if (text != "") {
-        QList<QTreeWidgetItem *> l_items = getCurrentTree()->findItems(
-            ui->searchLine->text(), Qt::MatchContains | Qt::MatchRecursive, 1);
-        foreach (QTreeWidgetItem *item, l_items) {
-            if (item->parent() != nullptr)
-                item->parent()->setHidden(false);
-            item->setHidden(false);
+    // Songs stay in one batch with their category
+    bool l_has_categories = ConfigFile::hasCategories(m_drop_key);
+    int l_size = qMin(DROP_BATCH, m_drop_items.size());
+    while (l_has_categories && l_size < m_drop_items.size() && !ConfigFile::isCategory(m_drop_items[l_size]))
+        l_size++;
+
+    QStringList l_batch = m_drop_items.mid(0, l_size);
+    m_drop_items.erase(m_drop_items.begin(), m_drop_items.begin() + l_size);
+
+    QTreeWidget *l_tree = m_drop_workspace->configs[m_drop_key];
+    int l_first = lastId(l_tree) + 1;
+    addItems(l_batch, l_tree, l_has_categories ? m_category_flags : m_item_flags);
+    m_drop_count += l_batch.size();
+
+    if (ConfigFile::hasLengths(m_drop_key)) {
+        for (int i = 0; i < l_batch.size(); i++) {
+            int l_id = l_first + i;
+            bool l_category = ConfigFile::isCategory(l_batch[i]);
+            setMusicLength(m_drop_workspace, l_id, l_category ? "category" : "0");
+            if (!l_category && !m_base_folder.isEmpty())
+                requestLength(m_drop_workspace, l_id, l_batch[i]);
         }
     }
+
+    ui->statusbar->showMessage(tr("Adding dropped items... %1 left").arg(m_drop_items.size()));
 }
 
-void Program::onItemClicked(QTreeWidgetItem *item)
+QVector<ConfigEntry> Program::configEntries(const QString &key)
 {
-    if (ui->configList->currentIndex() == 3) {
-        int l_id = item->text(0).toInt();
-        if (l_id <= m_music_length.size())
-            ui->lengthLine->setText(m_music_length[l_id - 1]);
-    }
-
-    if (m_base_folder.isEmpty())
-        return;
-
-    ui->animbgList->clear();
-    ui->chariconLabel->clear();
-    QString l_dir = m_base_folder + getCurrentFolder() + getCurrentTree()->currentItem()->text(1);
+    QVector<ConfigEntry> l_entries;
+    bool l_has_lengths = ConfigFile::hasLengths(key);
+    forEachEntry(m_workspace->configs[key], [this, &l_entries, l_has_lengths](int id, const QString &name) {
+        l_entries.append(ConfigEntry{name, l_has_lengths ? m_workspace->music_length[id - 1] : QString()});
+    });
 
-    switch (ui->configList->currentIndex()) {
-    case 0:
-    case 1:
-    {
-        l_dir = l_dir + "/";
-        QDirIterator l_files(l_dir, QDir::Files, QDirIterator::Subdirectories);
+    return l_entries;
+}
 
-        while (l_files.hasNext()) {
-            QString l_file = l_files.next().remove(l_dir);
-            if (l_file.startsWith("char_icon"))
-                ui->chariconLabel->setPixmap(QPixmap(l_dir + l_file).scaled(80, 80));
-            else if (l_file.startsWith("emotions"))
-                continue;
-            else if (l_file.endsWith(".png") || l_file.endsWith(".webp") || l_file.endsWith(".gif") || l_file.endsWith(".apng"))
-                ui->animbgList->addItem(l_file);
-        }
+void Program::setConfigEntries(QString key, QVector<ConfigEntry> entries)
+{
+    m_workspace->undo_stack->clear(); // Renames refer to ids of the replaced items
+    fillConfig(m_workspace, key, entries);
+}
 
-        break;
-    }
-    case 2:
-    case 3:
-    {
-        m_channel = getMusic(l_dir);
-        break;
-    }
-    default:
-        break;
+void Program::fillConfig(Workspace *workspace, const QString &key, const QVector<ConfigEntry> &entries)
+{
+    QStringList l_items;
+    l_items.reserve(entries.size());
+    for (const ConfigEntry &l_entry : entries)
+        l_items.append(l_entry.name);
+
+    QTreeWidget *l_tree = workspace->configs[key];
+    l_tree->clear();
+    if (ConfigFile::hasLengths(key)) {
+        workspace->music_length.clear();
+        for (const ConfigEntry &l_entry : entries)
+            workspace->music_length.append(m_string_pool.shared(l_entry.length)); // Mostly "category" and a few common lengths
     }
 
-    qDebug() << "Selected file's path is " + l_dir;
+    addItems(l_items, l_tree, ConfigFile::hasCategories(key) ? m_category_flags : m_item_flags);
 }
 
-void Program::onItemDoubleClicked(QTreeWidgetItem *item, int column)
+void Program::forEachEntry(QTreeWidget *widget, const std::function<void(int, const QString &)> &function)
 {
-    if (column == 1)
-        getCurrentTree()->editItem(item, column);
+    for (int i = 0; i < widget->topLevelItemCount(); i++)
+        forEachEntry(widget->topLevelItem(i), function);
 }
 
-void Program::dragEnterEvent(QDragEnterEvent *event)
+void Program::forEachEntry(QTreeWidgetItem *item, const std::function<void(int, const QString &)> &function)
 {
-    if (event->mimeData()->hasUrls()) {
-        event->acceptProposedAction();
+    function(item->text(0).toInt(), item->text(1));
+
+    // One buffer for all songs that aren't created yet, it's copied only by functions that keep names
+    PendingChildren l_children = pendingChildren(item);
+    QString l_name;
+    for (int i = 0; i < l_children.names.size(); i++) {
+        m_string_pool.name(l_children.names[i], &l_name);
+        function(l_children.ids[i], l_name);
     }
+
+    for (int i = 0; i < item->childCount(); i++)
+        forEachEntry(item->child(i), function);
 }
 
-void Program::dropEvent(QDropEvent *event)
+QTreeWidgetItem *Program::findEntry(QTreeWidget *widget, int id)
 {
-    QStringList l_items;
-    foreach (const QUrl &url, event->mimeData()->urls())
-        l_items.append(url.fileName());
+    QTreeWidgetItemIterator l_iter(widget);
+    while (*l_iter) {
+        if ((*l_iter)->text(0).toInt() == id)
+            return *l_iter;
+
+        if (pendingChildren(*l_iter).ids.contains(id)) {
+            QTreeWidgetItem *l_category = *l_iter;
+            materializeChildren(l_category);
+            for (int i = 0; i < l_category->childCount(); i++)
+                if (l_category->child(i)->text(0).toInt() == id)
+                    return l_category->child(i);
+        }
 
-    Qt::ItemFlags l_parent_flags;
-    QTreeWidget *l_widget = getCurrentTree();
-    if (l_widget == ui->treebackgrounds || l_widget == ui->treecharacters)
-        l_parent_flags = m_item_flags;
-    else
-        l_parent_flags = m_category_flags;
+        ++l_iter;
+    }
 
-    addItems(l_items, l_widget, l_parent_flags);
+    return nullptr;
+}
 
-    if (l_widget == ui->treemusicjson)
-        for (int i = 0; i < l_items.size(); i++)
-            m_music_length.append("0");
+void Program::setMusicLength(Workspace *workspace, int id, const QString &length)
+{
+    while (workspace->music_length.size() < id)
+        workspace->music_length.append("0");
+    workspace->music_length[id - 1] = length;
 }
 
-long Program::itemsCount(QTreeWidget *widget)
+int Program::lastId(QTreeWidget *widget)
 {
+    // Only ids are needed, so names of songs that aren't created yet aren't built
+    int l_last = 0;
     QTreeWidgetItemIterator l_iter(widget);
-    long l_count = 0;
     while (*l_iter) {
-        l_count++;
+        l_last = qMax(l_last, (*l_iter)->text(0).toInt());
+        const QVector<int> l_ids = pendingChildren(*l_iter).ids;
+        for (int l_id : l_ids)
+            l_last = qMax(l_last, l_id);
         ++l_iter;
     }
+    return l_last;
+}
 
+long Program::itemsCount(QTreeWidget *widget)
+{
+    long l_count = 0;
+    forEachEntry(widget, [&l_count](int, const QString &) { l_count++; });
     return l_count;
 }
 
-void Program::addItems(QStringList items, QTreeWidget *widget, Qt::ItemFlags parent_flags)
+void Program::addItems(QStringList items, QTreeWidget *widget, Qt::ItemFlags parent_flags, const QVector<int> &ids)
 {
     int id = 1;
-    int l_count = itemsCount(widget);
+    int l_count = lastId(widget); // New ids follow the greatest live id, so the ids of deleted last items are reused
     QTreeWidgetItem *l_parent = nullptr;
+    PendingChildren l_children;
+    QList<QTreeWidgetItem *> l_top_items;
     for (const QString &l_item : qAsConst(items)) {
         if (l_item == "." || l_item == "..")
             continue;
 
         QString l_item_name = l_item.left(l_item.lastIndexOf("."));
         l_item_name = l_item_name.right(l_item_name.length() - (l_item_name.lastIndexOf("/") + 1));
-        QTreeWidgetItem *l_tree_item;
-        if (l_item_name != l_item && l_parent != nullptr) {
-            l_tree_item = new QTreeWidgetItem(l_parent);
-            l_tree_item->setData(0, Qt::DisplayRole, l_count + id);
-            l_tree_item->setData(1, Qt::DisplayRole, l_item);
-            l_tree_item->setFlags(m_item_flags);
+        if (l_item_name != l_item && l_parent != nullptr) { // Songs are created when their category is expanded
+            l_children.names.append(m_string_pool.intern(l_item));
+            l_children.ids.append(ids.isEmpty() ? l_count + id : ids[id - 1]);
         }
         else {
-            l_tree_item = new QTreeWidgetItem(widget);
-            l_tree_item->setData(0, Qt::DisplayRole, l_count + id);
+            if (l_parent != nullptr) {
+                setPendingChildren(l_parent, l_children);
+                l_children = PendingChildren();
+            }
+
+            QTreeWidgetItem *l_tree_item = new QTreeWidgetItem;
+            l_tree_item->setData(0, Qt::DisplayRole, ids.isEmpty() ? l_count + id : ids[id - 1]);
             l_tree_item->setData(1, Qt::DisplayRole, l_item);
             l_tree_item->setFlags(parent_flags);
+            l_top_items.append(l_tree_item);
+            if (l_item_name == l_item)
+                l_parent = l_tree_item;
         }
-        if (l_item_name == l_item)
-            l_parent = l_tree_item;
 
         id++;
     }
+
+    if (l_parent != nullptr)
+        setPendingChildren(l_parent, l_children);
+
+    widget->addTopLevelItems(l_top_items);
+}
+
+void Program::onItemExpanded(QTreeWidgetItem *item)
+{
+    materializeChildren(item);
+}
+
+void Program::materializeChildren(QTreeWidgetItem *item)
+{
+    PendingChildren l_children = pendingChildren(item);
+    if (l_children.names.isEmpty())
+        return;
+
+    m_journal_paused++; // Creating items isn't an edit
+    item->setData(0, PendingChildrenRole, QVariant());
+    QList<QTreeWidgetItem *> l_items;
+    l_items.reserve(l_children.names.size());
+    for (int i = 0; i < l_children.names.size(); i++) {
+        QTreeWidgetItem *l_child = new QTreeWidgetItem;
+        l_child->setData(0, Qt::DisplayRole, l_children.ids[i]);
+        l_child->setData(1, Qt::DisplayRole, m_string_pool.name(l_children.names[i]));
+        l_child->setFlags(m_item_flags);
+        l_items.append(l_child);
+    }
+
+    item->insertChildren(0, l_items);
+    item->setChildIndicatorPolicy(QTreeWidgetItem::DontShowIndicatorWhenChildless);
+    m_journal_paused--;
+}
+
+void Program::compactStringPool()
+{
+    QSet<int> l_used;
+    for (const Workspace *l_workspace : qAsConst(m_workspaces))
+        for (QTreeWidget *l_tree : l_workspace->configs)
+            for (int i = 0; i < l_tree->topLevelItemCount(); i++) {
+                const PendingChildren l_children = pendingChildren(l_tree->topLevelItem(i));
+                for (int l_name : l_children.names)
+                    l_used.insert(l_name);
+            }
+
+    // Names of closed and reloaded configs are dropped once they're most of the pool
+    if (m_string_pool.count() <= 2 * l_used.size() + COMPACT_MIN_NODES)
+        return;
+
+    const QHash<int, int> l_ids = m_string_pool.compact(l_used);
+    m_journal_paused++;
+    for (const Workspace *l_workspace : qAsConst(m_workspaces))
+        for (QTreeWidget *l_tree : l_workspace->configs)
+            for (int i = 0; i < l_tree->topLevelItemCount(); i++) {
+                PendingChildren l_children = pendingChildren(l_tree->topLevelItem(i));
+                if (l_children.names.isEmpty())
+                    continue;
+
+                for (int &l_name : l_children.names)
+                    l_name = l_ids.value(l_name);
+                setPendingChildren(l_tree->topLevelItem(i), l_children);
+            }
+    m_journal_paused--;
+}
+
+PendingChildren Program::pendingChildren(const QTreeWidgetItem *item)
+{
+    return item->data(0, PendingChildrenRole).value<PendingChildren>();
+}
+
+void Program::setPendingChildren(QTreeWidgetItem *item, const PendingChildren &children)
+{
+    if (children.names.isEmpty())
+        return;
+
+    item->setData(0, PendingChildrenRole, QVariant::fromValue(children));
+    item->setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
 }
 
 QTreeWidget *Program::getCurrentTree()
 {
     switch (ui->configList->currentIndex()) {
     case 0:
-        return ui->treebackgrounds;
+        return m_workspace->configs["/backgrounds.txt"];
     case 1:
-        return ui->treecharacters;
+        return m_workspace->configs["/characters.txt"];
     case 2:
-        return ui->treemusictxt;
+        return m_workspace->configs["/music.txt"];
     case 3:
-        return ui->treemusicjson;
+        return m_workspace->configs["/music.json"];
     }
 
     return nullptr;
@@ -558,15 +2516,51 @@ QString Program::getCurrentFolder()
 
 DWORD Program::getMusic(QString dir)
 {
+    // Prescanning builds the seek table, so seeks are exact and don't decode from the start
     if (dir.endsWith(".opus"))
-        return BASS_OPUS_StreamCreateFile(FALSE, dir.utf16(), 0, 0, BASS_UNICODE);
-    else if (dir.endsWith(".mid"))
+        return BASS_OPUS_StreamCreateFile(FALSE, dir.utf16(), 0, 0, BASS_UNICODE | BASS_STREAM_PRESCAN);
+    else if (MidiFile::isMidi(dir))
         return BASS_MIDI_StreamCreateFile(FALSE, dir.utf16(), 0, 0, BASS_UNICODE, 1);
     else
-        return BASS_StreamCreateFile(FALSE, dir.utf16(), 0, 0, BASS_UNICODE);
+        return BASS_StreamCreateFile(FALSE, dir.utf16(), 0, 0, BASS_UNICODE | BASS_STREAM_PRESCAN);
 }
 
 Program::~Program()
 {
+    // Songs are decoded on the "no sound" device by worker threads, so they stop before the devices are freed
+    m_length_prober.cancel();
+    m_waveform_cache->cancel();
+    m_audit_watcher.waitForFinished();
+    m_drop_watcher.waitForFinished();
+    m_save_watcher.waitForFinished();
+    for (Workspace *l_workspace : qAsConst(m_workspaces))
+        if (l_workspace->loader != nullptr) {
+            l_workspace->loader->disconnect(this);
+            l_workspace->loader->cancel();
+            l_workspace->loader->waitForFinished();
+        }
+    flushJournals();
+    if (ui->actionRestore_session->isChecked())
+        saveSession();
+    for (Workspace *l_workspace : qAsConst(m_workspaces)) {
+        delete l_workspace->journal;
+        for (QTreeWidget *l_tree : qAsConst(l_workspace->configs)) { // Trees outlive this object's members
+            l_tree->disconnect(this);
+            l_tree->model()->disconnect(this);
+        }
+    }
+    m_duration_cache.save(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/durations.dat");
+    m_manifest_watcher.waitForFinished();
+    m_transcoder.disconnect(this);
+    m_transcoder.cancel();
+    m_unused_watcher.waitForFinished();
+    m_hash_cache.save(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/hashes.dat");
+
+    // BASS_Free frees the device selected in this thread
+    if (m_audio_device >= 0 && BASS_SetDevice(m_audio_device))
+        BASS_Free();
+    if (BASS_SetDevice(0))
+        BASS_Free();
+    qDeleteAll(m_workspaces);
     delete ui;
 }
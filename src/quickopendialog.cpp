@@ -0,0 +1,70 @@
+#include "include/quickopendialog.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QKeyEvent>
+#include <QVBoxLayout>
+
+QuickOpenDialog::QuickOpenDialog(const FuzzyFinder *finder, QWidget *parent) :
+    QDialog(parent),
+    m_finder(finder)
+{
+    setWindowTitle(tr("Quick open"));
+    resize(500, 400);
+
+    m_query = new QLineEdit(this);
+    m_query->setPlaceholderText(tr("Search in all configs..."));
+    m_query->installEventFilter(this);
+    m_results = new QListWidget(this);
+    m_results->setUniformItemSizes(true);
+    m_status = new QLabel(tr("%1 items").arg(m_finder->count()), this);
+
+    connect(m_query, &QLineEdit::textChanged, this, &QuickOpenDialog::queryChanged);
+    connect(m_query, &QLineEdit::returnPressed, this, [this] {
+        if (m_results->currentItem() != nullptr)
+            accept();
+    });
+    connect(m_results, &QListWidget::itemActivated, this, &QDialog::accept);
+
+    QVBoxLayout *l_layout = new QVBoxLayout(this);
+    l_layout->addWidget(m_query);
+    l_layout->addWidget(m_results);
+    l_layout->addWidget(m_status);
+}
+
+int QuickOpenDialog::selectedIndex() const
+{
+    QListWidgetItem *l_item = m_results->currentItem();
+    return l_item == nullptr ? -1 : l_item->data(Qt::UserRole).toInt();
+}
+
+bool QuickOpenDialog::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched == m_query && event->type() == QEvent::KeyPress) {
+        int l_key = static_cast<QKeyEvent *>(event)->key();
+        if (l_key == Qt::Key_Up || l_key == Qt::Key_Down || l_key == Qt::Key_PageUp || l_key == Qt::Key_PageDown) {
+            QCoreApplication::sendEvent(m_results, event);
+            return true;
+        }
+    }
+
+    return QDialog::eventFilter(watched, event);
+}
+
+void QuickOpenDialog::queryChanged(QString query)
+{
+    QElapsedTimer l_timer;
+    l_timer.start();
+    QVector<FuzzyMatch> l_matches = m_finder->find(query, MAX_RESULTS);
+    qint64 l_elapsed = l_timer.elapsed();
+
+    m_results->clear();
+    for (const FuzzyMatch &l_match : qAsConst(l_matches)) {
+        const FinderEntry &l_entry = m_finder->entry(l_match.index);
+        QListWidgetItem *l_item = new QListWidgetItem(l_entry.name + "  (" + l_entry.config.mid(1) + ")", m_results);
+        l_item->setData(Qt::UserRole, l_match.index);
+    }
+
+    if (m_results->count() > 0)
+        m_results->setCurrentRow(0);
+    m_status->setText(tr("%1 of %2 items in %3 ms").arg(l_matches.size()).arg(m_finder->count()).arg(l_elapsed));
+}
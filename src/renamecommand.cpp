@@ -0,0 +1,21 @@
+#include "include/renamecommand.h"
+#include "include/program.h"
+
+RenameCommand::RenameCommand(Program *program, Workspace *workspace, const QString &key, const QVector<RenameChange> &changes) :
+    m_program(program),
+    m_workspace(workspace),
+    m_key(key),
+    m_changes(changes)
+{
+    setText(QObject::tr("Rename %n items", nullptr, m_changes.size()));
+}
+
+void RenameCommand::undo()
+{
+    m_program->renameEntries(m_workspace, m_key, m_changes, true);
+}
+
+void RenameCommand::redo()
+{
+    m_program->renameEntries(m_workspace, m_key, m_changes, false);
+}
@@ -0,0 +1,87 @@
+#include "include/renamepreviewmodel.h"
+#include <QBrush>
+
+RenamePreviewModel::RenamePreviewModel(QObject *parent) :
+    QAbstractTableModel(parent)
+{
+}
+
+void RenamePreviewModel::setPreview(const QStringList &old_names, const QVector<QString> &new_names, const QVector<Status> &statuses)
+{
+    beginResetModel();
+    m_old_names = old_names;
+    m_new_names = new_names;
+    m_statuses = statuses;
+    endResetModel();
+}
+
+int RenamePreviewModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_old_names.size();
+}
+
+int RenamePreviewModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : 3;
+}
+
+QVariant RenamePreviewModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+
+    Status l_status = m_statuses[index.row()];
+    if (role == Qt::ForegroundRole) {
+        if (l_status == Unchanged)
+            return QBrush(Qt::gray);
+        if (l_status == Duplicate || l_status == EmptyName)
+            return QBrush(Qt::red);
+        if ((l_status == MissingAsset || l_status == Repeated) && index.column() == 2)
+            return QBrush(Qt::darkYellow);
+        return QVariant();
+    }
+
+    if (role != Qt::DisplayRole)
+        return QVariant();
+
+    switch (index.column()) {
+    case 0:
+        return m_old_names[index.row()];
+    case 1:
+        return m_new_names[index.row()];
+    case 2:
+        switch (l_status) {
+        case Unchanged:
+            return tr("Unchanged");
+        case Renamed:
+            return tr("OK");
+        case MissingAsset:
+            return tr("No such asset");
+        case Duplicate:
+            return tr("Duplicate");
+        case EmptyName:
+            return tr("Empty name");
+        case Repeated:
+            return tr("Listed again");
+        }
+    }
+
+    return QVariant();
+}
+
+QVariant RenamePreviewModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+        return QVariant();
+
+    switch (section) {
+    case 0:
+        return tr("Name");
+    case 1:
+        return tr("New name");
+    case 2:
+        return tr("Status");
+    }
+
+    return QVariant();
+}
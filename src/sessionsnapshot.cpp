@@ -0,0 +1,93 @@
+#include "include/sessionsnapshot.h"
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+bool SessionSnapshot::write(const QString &filename, const AssetIndex &index, const QVector<SessionWorkspace> &workspaces)
+{
+    QDir().mkpath(QFileInfo(filename).absolutePath());
+    QSaveFile l_file(filename);
+    if (!l_file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream l_out(&l_file);
+    l_out.setVersion(QDataStream::Qt_5_9);
+    l_out << MAGIC << VERSION;
+    index.write(l_out);
+
+    l_out << quint32(workspaces.size());
+    for (const SessionWorkspace &l_workspace : workspaces) {
+        l_out << l_workspace.config_folder << quint32(l_workspace.configs.size());
+        for (auto l_iter = l_workspace.configs.cbegin(); l_iter != l_workspace.configs.cend(); ++l_iter) {
+            AssetInfo l_stamp = l_workspace.stamps.value(l_iter.key());
+            l_out << l_iter.key() << l_stamp.size << l_stamp.modified << l_iter->ids << l_iter->names;
+        }
+        l_out << l_workspace.music_length;
+    }
+
+    return l_out.status() == QDataStream::Ok && l_file.commit();
+}
+
+bool SessionSnapshot::read(const QString &filename, AssetIndex *index, QVector<SessionWorkspace> *workspaces)
+{
+    QFile l_file(filename);
+    if (!l_file.open(QIODevice::ReadOnly) || l_file.size() == 0)
+        return false;
+
+    // Strings are decoded straight from the mapped file
+    uchar *l_map = l_file.map(0, l_file.size());
+    if (l_map == nullptr)
+        return false;
+
+    QByteArray l_data = QByteArray::fromRawData(reinterpret_cast<const char *>(l_map), int(l_file.size()));
+    QDataStream l_in(l_data);
+    l_in.setVersion(QDataStream::Qt_5_9);
+
+    quint32 l_magic;
+    quint32 l_version;
+    l_in >> l_magic >> l_version;
+    bool l_ok = l_magic == MAGIC && l_version == VERSION && index->read(l_in);
+
+    quint32 l_count = 0;
+    if (l_ok)
+        l_in >> l_count;
+    for (quint32 i = 0; l_ok && i < l_count && l_in.status() == QDataStream::Ok; i++) {
+        SessionWorkspace l_workspace;
+        quint32 l_configs;
+        l_in >> l_workspace.config_folder >> l_configs;
+        for (quint32 j = 0; j < l_configs && l_in.status() == QDataStream::Ok; j++) {
+            QString l_key;
+            AssetInfo l_stamp;
+            JournalConfig l_config;
+            l_in >> l_key >> l_stamp.size >> l_stamp.modified >> l_config.ids >> l_config.names;
+            l_workspace.stamps.insert(l_key, l_stamp);
+            l_workspace.configs.insert(l_key, l_config);
+        }
+        l_in >> l_workspace.music_length;
+        workspaces->append(l_workspace);
+    }
+
+    l_ok = l_ok && l_in.status() == QDataStream::Ok;
+    l_file.unmap(l_map);
+    return l_ok;
+}
+
+AssetInfo SessionSnapshot::stamp(const QString &path)
+{
+    QFileInfo l_file(path);
+    AssetInfo l_stamp;
+    if (l_file.exists()) {
+        l_stamp.size = l_file.size();
+        l_stamp.modified = l_file.lastModified().toMSecsSinceEpoch();
+    }
+
+    return l_stamp;
+}
+
+QString SessionSnapshot::location()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/session.dat";
+}
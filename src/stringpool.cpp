@@ -0,0 +1,171 @@
+#include "include/stringpool.h"
+#include "include/fnvhash.h"
+#include <QByteArray>
+#include <algorithm>
+
+int StringPool::intern(const QString &name)
+{
+    if (m_table.isEmpty())
+        grow();
+
+    int l_node = -1;
+    int l_begin = 0;
+    while (true) {
+        int l_end = name.indexOf('/', l_begin);
+        int l_length = (l_end < 0 ? name.size() : l_end) - l_begin;
+        const QChar *l_segment = name.constData() + l_begin;
+        int l_slot = slot(l_node, l_segment, l_length);
+        if (m_table[l_slot] >= 0)
+            l_node = m_table[l_slot];
+        else {
+            m_nodes.append(Node{l_node, m_text.size()});
+            for (int i = 0; i < l_length; i++)
+                m_text.append(l_segment[i]);
+            l_node = m_nodes.size() - 1;
+            m_table[l_slot] = l_node;
+            if (m_nodes.size() * 2 > m_table.size())
+                grow();
+        }
+
+        if (l_end < 0)
+            return l_node;
+        l_begin = l_end + 1;
+    }
+}
+
+int StringPool::find(const QString &name) const
+{
+    if (m_table.isEmpty())
+        return -1;
+
+    int l_node = -1;
+    int l_begin = 0;
+    while (true) {
+        int l_end = name.indexOf('/', l_begin);
+        int l_length = (l_end < 0 ? name.size() : l_end) - l_begin;
+        l_node = m_table[slot(l_node, name.constData() + l_begin, l_length)];
+        if (l_node < 0 || l_end < 0)
+            return l_node;
+        l_begin = l_end + 1;
+    }
+}
+
+QString StringPool::name(int id) const
+{
+    QString l_name;
+    name(id, &l_name);
+    return l_name;
+}
+
+void StringPool::name(int id, QString *buffer) const
+{
+    if (id < 0 || id >= m_nodes.size()) {
+        buffer->clear();
+        return;
+    }
+
+    int l_length = -1;
+    for (int l_node = id; l_node >= 0; l_node = m_nodes[l_node].parent)
+        l_length += segmentLength(l_node) + 1;
+
+    // Filled from the end, the segments are visited from the leaf
+    buffer->resize(l_length);
+    QChar *l_data = buffer->data();
+    int l_pos = l_length;
+    for (int l_node = id; l_node >= 0; l_node = m_nodes[l_node].parent) {
+        int l_segment = segmentLength(l_node);
+        l_pos -= l_segment;
+        std::copy(m_text.constData() + m_nodes[l_node].offset, m_text.constData() + m_nodes[l_node].offset + l_segment, l_data + l_pos);
+        if (l_pos > 0)
+            l_data[--l_pos] = '/';
+    }
+}
+
+bool StringPool::equals(int id, const QString &name) const
+{
+    if (id < 0 || id >= m_nodes.size())
+        return false;
+
+    int l_pos = name.size();
+    for (int l_node = id; l_node >= 0; l_node = m_nodes[l_node].parent) {
+        int l_segment = segmentLength(l_node);
+        l_pos -= l_segment;
+        if (l_pos < 0 || !std::equal(m_text.constData() + m_nodes[l_node].offset, m_text.constData() + m_nodes[l_node].offset + l_segment, name.constData() + l_pos))
+            return false;
+        if (m_nodes[l_node].parent >= 0 && (l_pos == 0 || name[--l_pos] != '/'))
+            return false;
+    }
+    return l_pos == 0;
+}
+
+QString StringPool::shared(const QString &text)
+{
+    auto l_iter = m_shared.constFind(text);
+    if (l_iter != m_shared.constEnd())
+        return *l_iter;
+
+    m_shared.insert(text);
+    return text;
+}
+
+QHash<int, int> StringPool::compact(const QSet<int> &used)
+{
+    StringPool l_pool;
+    QHash<int, int> l_ids;
+    l_ids.reserve(used.size());
+    QString l_name;
+    for (int l_id : used) {
+        name(l_id, &l_name);
+        l_ids.insert(l_id, l_pool.intern(l_name));
+    }
+
+    m_text = l_pool.m_text;
+    m_nodes = l_pool.m_nodes;
+    m_table = l_pool.m_table;
+    m_text.squeeze();
+    m_nodes.squeeze();
+    return l_ids;
+}
+
+int StringPool::count() const
+{
+    return m_nodes.size();
+}
+
+qint64 StringPool::bytes() const
+{
+    return qint64(m_text.capacity()) * sizeof(QChar) + qint64(m_nodes.capacity()) * sizeof(Node) + qint64(m_table.capacity()) * sizeof(int);
+}
+
+int StringPool::slot(int parent, const QChar *segment, int length) const
+{
+    const int l_mask = m_table.size() - 1;
+    int l_slot = int(hash(parent, segment, length)) & l_mask;
+    while (m_table[l_slot] >= 0) {
+        int l_node = m_table[l_slot];
+        if (m_nodes[l_node].parent == parent && segmentLength(l_node) == length && std::equal(segment, segment + length, m_text.constData() + m_nodes[l_node].offset))
+            return l_slot;
+        l_slot = (l_slot + 1) & l_mask;
+    }
+    return l_slot;
+}
+
+int StringPool::segmentLength(int node) const
+{
+    return (node + 1 < m_nodes.size() ? m_nodes[node + 1].offset : m_text.size()) - m_nodes[node].offset;
+}
+
+void StringPool::grow()
+{
+    m_table = QVector<int>(m_table.isEmpty() ? 64 : m_table.size() * 2, -1);
+    for (int l_node = 0; l_node < m_nodes.size(); l_node++) {
+        const QChar *l_segment = m_text.constData() + m_nodes[l_node].offset;
+        m_table[slot(m_nodes[l_node].parent, l_segment, segmentLength(l_node))] = l_node;
+    }
+}
+
+uint StringPool::hash(int parent, const QChar *segment, int length)
+{
+    QByteArray l_bytes = QByteArray::fromRawData(reinterpret_cast<const char *>(segment), length * int(sizeof(QChar)));
+    return FnvHash::hash32(l_bytes) ^ (uint(parent) * 2654435761u);
+}
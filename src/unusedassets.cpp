@@ -0,0 +1,92 @@
+#include "include/unusedassets.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QtConcurrent>
+#include <algorithm>
+
+QString UnusedAssets::assetOf(const QString &path)
+{
+    static const QString l_music = "sounds/music/";
+    if (path.startsWith(l_music))
+        return path;
+
+    if (!path.startsWith("background/") && !path.startsWith("characters/"))
+        return QString();
+
+    int l_slash = path.indexOf('/', path.indexOf('/') + 1);
+    return l_slash < 0 ? path : path.left(l_slash);
+}
+
+QStringList UnusedAssets::referencedPaths(const QString &name)
+{
+    QString l_name = name.toLower();
+    return {"background/" + l_name, "characters/" + l_name, "sounds/music/" + l_name};
+}
+
+QVector<UnusedAsset> UnusedAssets::find(const AssetIndex &index, const QSet<QString> &used)
+{
+    const QHash<QString, AssetInfo> &l_assets = index.assets();
+    QVector<QHash<QString, AssetInfo>::const_iterator> l_items;
+    l_items.reserve(l_assets.size());
+    for (auto l_iter = l_assets.cbegin(); l_iter != l_assets.cend(); ++l_iter)
+        l_items.append(l_iter);
+
+    struct Chunk
+    {
+        int begin;
+        int end;
+        QHash<QString, UnusedAsset> unused;
+    };
+
+    QVector<Chunk> l_chunks;
+    for (int i = 0; i < l_items.size(); i += CHUNK_SIZE)
+        l_chunks.append(Chunk{i, qMin(i + CHUNK_SIZE, l_items.size()), QHash<QString, UnusedAsset>()});
+
+    QtConcurrent::blockingMap(l_chunks, [&l_items, &used](Chunk &chunk) {
+        for (int i = chunk.begin; i < chunk.end; i++) {
+            const QString &l_path = l_items[i].key();
+            if (l_path.startsWith("sounds/music/") && l_items[i]->is_dir)
+                continue; // Folders of songs aren't songs
+
+            QString l_asset = assetOf(l_path);
+            if (l_asset.isEmpty() || used.contains(l_asset.toLower()))
+                continue;
+
+            UnusedAsset &l_unused = chunk.unused[l_asset];
+            l_unused.path = l_asset;
+            if (!l_items[i]->is_dir) {
+                l_unused.size += l_items[i]->size;
+                l_unused.files++;
+            }
+        }
+    });
+
+    QHash<QString, UnusedAsset> l_merged;
+    for (const Chunk &l_chunk : qAsConst(l_chunks))
+        for (auto l_iter = l_chunk.unused.cbegin(); l_iter != l_chunk.unused.cend(); ++l_iter) {
+            UnusedAsset &l_unused = l_merged[l_iter.key()];
+            l_unused.path = l_iter->path;
+            l_unused.size += l_iter->size;
+            l_unused.files += l_iter->files;
+        }
+
+    QVector<UnusedAsset> l_result;
+    l_result.reserve(l_merged.size());
+    for (const UnusedAsset &l_unused : qAsConst(l_merged))
+        l_result.append(l_unused);
+    std::sort(l_result.begin(), l_result.end(), [](const UnusedAsset &a, const UnusedAsset &b) { return a.size != b.size ? a.size > b.size : a.path < b.path; });
+    return l_result;
+}
+
+QStringList UnusedAssets::archive(const QString &base_folder, const QVector<UnusedAsset> &assets, const QString &archive_folder)
+{
+    QStringList l_failures;
+    QDir l_dir;
+    for (const UnusedAsset &l_asset : assets) {
+        QString l_target = archive_folder + "/" + l_asset.path;
+        if (QFileInfo::exists(l_target) || !l_dir.mkpath(QFileInfo(l_target).path()) || !l_dir.rename(base_folder + "/" + l_asset.path, l_target))
+            l_failures.append(l_asset.path);
+    }
+
+    return l_failures;
+}
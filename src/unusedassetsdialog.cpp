@@ -0,0 +1,77 @@
+#include "include/unusedassetsdialog.h"
+#include <QDialogButtonBox>
+#include <QHeaderView>
+#include <QPushButton>
+#include <QVBoxLayout>
+
+UnusedAssetsDialog::UnusedAssetsDialog(const QVector<UnusedAsset> &assets, qint64 elapsed, QWidget *parent) :
+    QDialog(parent),
+    m_assets(assets),
+    m_elapsed(elapsed)
+{
+    setWindowTitle(tr("Unused assets"));
+    resize(700, 500);
+
+    m_summary = new QLabel(this);
+    m_list = new QTreeWidget(this);
+    m_list->setColumnCount(3);
+    m_list->setHeaderLabels({tr("Asset"), tr("Size"), tr("Files")});
+    m_list->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+    m_list->header()->setStretchLastSection(false);
+    m_list->setRootIsDecorated(false);
+    m_list->setUniformRowHeights(true);
+
+    QList<QTreeWidgetItem *> l_items;
+    l_items.reserve(m_assets.size());
+    for (int i = 0; i < m_assets.size(); i++) {
+        const UnusedAsset &l_asset = m_assets[i];
+        QTreeWidgetItem *l_item = new QTreeWidgetItem(QStringList{l_asset.path, formatSize(l_asset.size), QString::number(l_asset.files)});
+        l_item->setFlags(l_item->flags() | Qt::ItemIsUserCheckable);
+        l_item->setCheckState(0, Qt::Checked);
+        l_item->setData(0, Qt::UserRole, i);
+        l_item->setTextAlignment(1, Qt::AlignRight | Qt::AlignVCenter);
+        l_item->setTextAlignment(2, Qt::AlignRight | Qt::AlignVCenter);
+        l_items.append(l_item);
+    }
+    m_list->addTopLevelItems(l_items);
+    connect(m_list, &QTreeWidget::itemChanged, this, &UnusedAssetsDialog::updateSummary);
+
+    QDialogButtonBox *l_buttons = new QDialogButtonBox(QDialogButtonBox::Close, this);
+    QPushButton *l_archive_button = l_buttons->addButton(tr("Move to archive..."), QDialogButtonBox::AcceptRole);
+    l_archive_button->setEnabled(!m_assets.isEmpty());
+    connect(l_buttons, &QDialogButtonBox::accepted, this, &QDialog::accept);
+    connect(l_buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+
+    QVBoxLayout *l_layout = new QVBoxLayout(this);
+    l_layout->addWidget(m_summary);
+    l_layout->addWidget(m_list);
+    l_layout->addWidget(l_buttons);
+
+    updateSummary();
+}
+
+QVector<UnusedAsset> UnusedAssetsDialog::checkedAssets() const
+{
+    QVector<UnusedAsset> l_assets;
+    for (int i = 0; i < m_list->topLevelItemCount(); i++) {
+        QTreeWidgetItem *l_item = m_list->topLevelItem(i);
+        if (l_item->checkState(0) == Qt::Checked)
+            l_assets.append(m_assets[l_item->data(0, Qt::UserRole).toInt()]);
+    }
+    return l_assets;
+}
+
+QString UnusedAssetsDialog::formatSize(qint64 size)
+{
+    return QString::number(size / 1048576.0, 'f', 1) + " MB";
+}
+
+void UnusedAssetsDialog::updateSummary()
+{
+    const QVector<UnusedAsset> l_checked = checkedAssets();
+    qint64 l_total = 0;
+    for (const UnusedAsset &l_asset : l_checked)
+        l_total += l_asset.size;
+
+    m_summary->setText(tr("%1 unused assets found in %2 ms. %3 checked assets take %4.").arg(m_assets.size()).arg(m_elapsed).arg(l_checked.size()).arg(formatSize(l_total)));
+}
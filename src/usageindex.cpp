@@ -0,0 +1,160 @@
+#include "include/usageindex.h"
+#include <QFile>
+#include <QTextStream>
+
+QVector<IniSection> UsageIndex::readIni(const QString &filename, bool *ok)
+{
+    QVector<IniSection> l_sections;
+    QFile l_file(filename);
+    bool l_ok = l_file.open(QIODevice::ReadOnly | QIODevice::Text);
+    if (ok != nullptr)
+        *ok = l_ok;
+    if (!l_ok)
+        return l_sections;
+
+    QTextStream l_stream(&l_file);
+    QString l_line;
+    while (l_stream.readLineInto(&l_line)) {
+        l_line = l_line.trimmed();
+        if (l_line.isEmpty() || l_line.startsWith(';') || l_line.startsWith('#'))
+            continue;
+
+        if (l_line.startsWith('[') && l_line.endsWith(']')) {
+            IniSection l_section;
+            l_section.name = l_line.mid(1, l_line.size() - 2);
+            l_sections.append(l_section);
+            continue;
+        }
+
+        int l_equal = l_line.indexOf('=');
+        if (l_equal < 0)
+            continue;
+        if (l_sections.isEmpty())
+            l_sections.append(IniSection()); // Keys before the first section, "General" of QSettings
+
+        QString l_key = l_line.left(l_equal).trimmed();
+        QString l_value = l_line.mid(l_equal + 1).trimmed();
+        if (l_value.size() > 1 && l_value.startsWith('"') && l_value.endsWith('"')) { // QSettings quotes strings with commas
+            l_sections.last().values.append(qMakePair(l_key, l_value.mid(1, l_value.size() - 2)));
+            continue;
+        }
+
+        const QStringList l_parts = l_value.split(',');
+        for (const QString &l_part : l_parts)
+            if (!l_part.trimmed().isEmpty())
+                l_sections.last().values.append(qMakePair(l_key, l_part.trimmed()));
+    }
+
+    return l_sections;
+}
+
+void UsageIndex::setIni(const QString &source, const QVector<IniSection> &sections)
+{
+    removeSource(source);
+    for (const IniSection &l_section : sections)
+        for (const auto &l_value : l_section.values)
+            add(l_value.second, AssetUse{source, l_section.name, l_value.first});
+}
+
+void UsageIndex::setConfig(const QString &key, const QStringList &names)
+{
+    removeSource(key);
+    m_stale.remove(key);
+    for (const QString &l_name : names)
+        add(l_name, AssetUse{key, QString(), QString()});
+}
+
+void UsageIndex::addNames(const QString &key, const QStringList &names)
+{
+    if (m_stale.contains(key))
+        return;
+
+    for (const QString &l_name : names)
+        add(l_name, AssetUse{key, QString(), QString()});
+}
+
+void UsageIndex::removeNames(const QString &key, const QStringList &names)
+{
+    if (m_stale.contains(key))
+        return;
+
+    auto l_source = m_sources.find(key);
+    if (l_source == m_sources.end())
+        return;
+
+    for (const QString &l_name : names) {
+        auto l_count = l_source->find(l_name);
+        if (l_count == l_source->end() || --l_count.value() > 0)
+            continue;
+
+        l_source->erase(l_count);
+        removeUse(l_name, key);
+    }
+}
+
+void UsageIndex::removeSource(const QString &source)
+{
+    const QHash<QString, int> l_assets = m_sources.take(source);
+    for (auto l_iter = l_assets.cbegin(); l_iter != l_assets.cend(); ++l_iter)
+        removeUse(l_iter.key(), source);
+}
+
+void UsageIndex::invalidate(const QString &key)
+{
+    m_stale.insert(key);
+}
+
+QStringList UsageIndex::takeStale()
+{
+    QStringList l_keys = m_stale.values();
+    m_stale.clear();
+    return l_keys;
+}
+
+QVector<AssetUse> UsageIndex::uses(const QString &asset) const
+{
+    return m_uses.value(asset);
+}
+
+QStringList UsageIndex::assets() const
+{
+    return m_uses.keys();
+}
+
+QStringList UsageIndex::iniSources() const
+{
+    QStringList l_sources;
+    for (auto l_iter = m_sources.cbegin(); l_iter != m_sources.cend(); ++l_iter)
+        if (!l_iter.key().startsWith('/'))
+            l_sources.append(l_iter.key());
+    return l_sources;
+}
+
+void UsageIndex::clear()
+{
+    m_uses.clear();
+    m_sources.clear();
+    m_stale.clear();
+}
+
+void UsageIndex::add(const QString &asset, const AssetUse &use)
+{
+    m_sources[use.source][asset]++;
+    QVector<AssetUse> &l_uses = m_uses[asset];
+    if (!l_uses.contains(use)) // Songs can be listed twice in one config
+        l_uses.append(use);
+}
+
+void UsageIndex::removeUse(const QString &asset, const QString &source)
+{
+    auto l_iter = m_uses.find(asset);
+    if (l_iter == m_uses.end())
+        return;
+
+    QVector<AssetUse> &l_uses = l_iter.value();
+    for (int i = l_uses.size() - 1; i >= 0; i--)
+        if (l_uses[i].source == source)
+            l_uses.remove(i);
+    if (l_uses.isEmpty())
+        m_uses.erase(l_iter);
+}
@@ -0,0 +1,140 @@
+#include "include/waveform.h"
+#include "include/lengthprober.h"
+#include <algorithm>
+
+Waveform Waveform::decode(const QString &path)
+{
+    Waveform l_waveform;
+    HSTREAM l_stream = LengthProber::openDecoder(path, BASS_SAMPLE_FLOAT);
+    if (l_stream == 0)
+        return l_waveform;
+
+    BASS_CHANNELINFO l_info;
+    BASS_ChannelGetInfo(l_stream, &l_info);
+    int l_channels = qMax<int>(l_info.chans, 1);
+    l_waveform.m_sample_rate = qMax<int>(l_info.freq, 1);
+
+    QVector<qint16> l_base;
+    QVector<float> l_buffer(BASE_FRAMES * l_channels * 64);
+    float l_min = 0, l_max = 0;
+    int l_frames = 0;
+    qint64 l_total = 0;
+    while (true) {
+        DWORD l_bytes = BASS_ChannelGetData(l_stream, l_buffer.data(), DWORD(l_buffer.size() * sizeof(float)));
+        if (l_bytes == DWORD(-1) || l_bytes == 0)
+            break;
+
+        int l_samples = int(l_bytes / sizeof(float));
+        for (int i = 0; i + l_channels <= l_samples; i += l_channels) {
+            for (int c = 0; c < l_channels; c++) {
+                l_min = qMin(l_min, l_buffer[i + c]);
+                l_max = qMax(l_max, l_buffer[i + c]);
+            }
+            if (++l_frames == BASE_FRAMES) {
+                l_base.append(qint16(qBound(-1.0f, l_min, 1.0f) * 32767));
+                l_base.append(qint16(qBound(-1.0f, l_max, 1.0f) * 32767));
+                l_min = l_max = 0;
+                l_frames = 0;
+            }
+        }
+        l_total += l_samples / l_channels;
+    }
+    BASS_StreamFree(l_stream);
+
+    if (l_frames > 0) {
+        l_base.append(qint16(qBound(-1.0f, l_min, 1.0f) * 32767));
+        l_base.append(qint16(qBound(-1.0f, l_max, 1.0f) * 32767));
+    }
+    if (l_base.isEmpty())
+        return Waveform();
+
+    l_waveform.m_length = double(l_total) / l_waveform.m_sample_rate;
+    l_waveform.m_levels.append(l_base);
+    l_waveform.buildLevels();
+    return l_waveform;
+}
+
+bool Waveform::isEmpty() const
+{
+    return m_levels.isEmpty();
+}
+
+double Waveform::length() const
+{
+    return m_length;
+}
+
+int Waveform::levelCount() const
+{
+    return m_levels.size();
+}
+
+int Waveform::bucketCount(int level) const
+{
+    return m_levels[level].size() / 2;
+}
+
+double Waveform::bucketLength(int level) const
+{
+    return double(BASE_FRAMES << level) / m_sample_rate;
+}
+
+int Waveform::levelFor(double seconds) const
+{
+    int l_level = 0;
+    while (l_level + 1 < m_levels.size() && bucketLength(l_level + 1) <= seconds)
+        l_level++;
+    return l_level;
+}
+
+void Waveform::peak(int level, int first, int last, qint16 *min, qint16 *max) const
+{
+    const QVector<qint16> &l_level = m_levels[level];
+    first = qMax(first, 0);
+    last = qMin(last, l_level.size() / 2 - 1);
+    *min = 0;
+    *max = 0;
+    for (int i = first; i <= last; i++) {
+        *min = qMin(*min, l_level[i * 2]);
+        *max = qMax(*max, l_level[i * 2 + 1]);
+    }
+}
+
+void Waveform::write(QDataStream &out) const
+{
+    if (m_levels.isEmpty()) {
+        out << qint32(0) << m_length << QVector<qint16>();
+        return;
+    }
+    out << qint32(m_sample_rate) << m_length << m_levels.first(); // Upper levels are cheap to rebuild
+}
+
+bool Waveform::read(QDataStream &in)
+{
+    qint32 l_sample_rate;
+    QVector<qint16> l_base;
+    in >> l_sample_rate >> m_length >> l_base;
+    m_levels.clear();
+    if (in.status() != QDataStream::Ok || l_sample_rate <= 0 || l_base.isEmpty() || l_base.size() % 2 != 0)
+        return in.status() == QDataStream::Ok;
+
+    m_sample_rate = l_sample_rate;
+    m_levels.append(l_base);
+    buildLevels();
+    return true;
+}
+
+void Waveform::buildLevels()
+{
+    while (m_levels.last().size() > 2) {
+        const QVector<qint16> &l_lower = m_levels.last();
+        QVector<qint16> l_level;
+        l_level.reserve(l_lower.size() / 2 + 2);
+        for (int i = 0; i < l_lower.size(); i += 4) {
+            bool l_pair = i + 3 < l_lower.size();
+            l_level.append(l_pair ? qMin(l_lower[i], l_lower[i + 2]) : l_lower[i]);
+            l_level.append(l_pair ? qMax(l_lower[i + 1], l_lower[i + 3]) : l_lower[i + 1]);
+        }
+        m_levels.append(l_level);
+    }
+}
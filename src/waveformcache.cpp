@@ -0,0 +1,135 @@
+#include "include/waveformcache.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QtConcurrent>
+
+WaveformCache::WaveformCache(const QString &folder, int max_cost_kb, QObject *parent) :
+    QObject(parent),
+    m_folder(folder)
+{
+    m_cache.setMaxCost(max_cost_kb);
+    m_pool.setMaxThreadCount(MAX_THREADS);
+    QtConcurrent::run(&m_pool, [folder] { trim(folder, MAX_DISK_SIZE); });
+}
+
+WaveformCache::~WaveformCache()
+{
+    cancel();
+}
+
+bool WaveformCache::find(const QString &path, Waveform *waveform) const
+{
+    const Waveform *l_waveform = m_cache.object(path);
+    if (l_waveform == nullptr)
+        return false;
+
+    *waveform = *l_waveform;
+    return true;
+}
+
+void WaveformCache::request(const QString &path)
+{
+    // Songs passed by while browsing the list are skipped if they haven't started yet
+    m_wanted = path;
+    for (auto l_iter = m_pending.cbegin(); l_iter != m_pending.cend(); ++l_iter)
+        l_iter.value()->storeRelease(l_iter.key() == path ? 0 : 1);
+
+    if (m_cache.contains(path) || m_pending.contains(path))
+        return;
+
+    QSharedPointer<QAtomicInt> l_cancelled(new QAtomicInt(0));
+    m_pending.insert(path, l_cancelled);
+    QFutureWatcher<LoadedWaveform> *l_watcher = new QFutureWatcher<LoadedWaveform>(this);
+    connect(l_watcher, &QFutureWatcher<LoadedWaveform>::finished, this, [this, l_watcher] { loadFinished(l_watcher); });
+    QString l_filename = filename(path);
+    l_watcher->setFuture(QtConcurrent::run(&m_pool, [path, l_filename, l_cancelled] { return load(path, l_filename, l_cancelled.data()); }));
+}
+
+void WaveformCache::cancel()
+{
+    m_wanted.clear();
+    for (const QSharedPointer<QAtomicInt> &l_cancelled : qAsConst(m_pending))
+        l_cancelled->storeRelease(1);
+    m_pool.waitForDone();
+}
+
+WaveformCache::LoadedWaveform WaveformCache::load(const QString &path, const QString &filename, const QAtomicInt *cancelled)
+{
+    LoadedWaveform l_loaded;
+    l_loaded.path = path;
+    if (cancelled->loadAcquire() != 0) {
+        l_loaded.cancelled = true;
+        return l_loaded;
+    }
+
+    QFileInfo l_song(path);
+    if (!l_song.exists())
+        return l_loaded;
+
+    qint64 l_size = l_song.size();
+    qint64 l_modified = l_song.lastModified().toMSecsSinceEpoch();
+
+    QFile l_file(filename);
+    if (l_file.open(QIODevice::ReadOnly)) {
+        QDataStream l_in(&l_file);
+        l_in.setVersion(QDataStream::Qt_5_9);
+        quint32 l_version;
+        QString l_path;
+        qint64 l_cached_size, l_cached_modified;
+        l_in >> l_version >> l_path >> l_cached_size >> l_cached_modified;
+        if (l_version == VERSION && l_path == path && l_cached_size == l_size && l_cached_modified == l_modified && l_loaded.waveform.read(l_in))
+            return l_loaded;
+    }
+
+    l_loaded.waveform = Waveform::decode(path);
+
+    QDir().mkpath(QFileInfo(filename).absolutePath());
+    QSaveFile l_save(filename);
+    if (l_save.open(QIODevice::WriteOnly)) {
+        QDataStream l_out(&l_save);
+        l_out.setVersion(QDataStream::Qt_5_9);
+        l_out << VERSION << path << l_size << l_modified;
+        l_loaded.waveform.write(l_out);
+        l_save.commit();
+    }
+
+    return l_loaded;
+}
+
+void WaveformCache::trim(const QString &folder, qint64 max_size)
+{
+    const QFileInfoList l_files = QDir(folder).entryInfoList({"*.wave"}, QDir::Files, QDir::Time); // Newest first
+    qint64 l_size = 0;
+    for (const QFileInfo &l_file : l_files) {
+        l_size += l_file.size();
+        if (l_size > max_size)
+            QFile::remove(l_file.absoluteFilePath());
+    }
+}
+
+void WaveformCache::loadFinished(QFutureWatcher<LoadedWaveform> *watcher)
+{
+    LoadedWaveform l_loaded = watcher->result();
+    watcher->deleteLater();
+    m_pending.remove(l_loaded.path);
+    if (l_loaded.cancelled) {
+        if (l_loaded.path == m_wanted) // Selected again after it was skipped
+            request(l_loaded.path);
+        return;
+    }
+
+    int l_cost = 1;
+    for (int i = 0; i < l_loaded.waveform.levelCount(); i++)
+        l_cost += l_loaded.waveform.bucketCount(i) * 4 / 1024;
+    m_cache.insert(l_loaded.path, new Waveform(l_loaded.waveform), l_cost);
+    emit waveformReady(l_loaded.path);
+}
+
+QString WaveformCache::filename(const QString &path) const
+{
+    QByteArray l_hash = QCryptographicHash::hash(QDir::cleanPath(path).toUtf8(), QCryptographicHash::Sha1).toHex();
+    return m_folder + "/" + QString::fromLatin1(l_hash) + ".wave";
+}
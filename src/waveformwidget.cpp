@@ -0,0 +1,154 @@
+#include "include/waveformwidget.h"
+#include <QMouseEvent>
+#include <QPainter>
+#include <QWheelEvent>
+#include <cmath>
+
+WaveformWidget::WaveformWidget(QWidget *parent) :
+    QWidget(parent)
+{
+    setAttribute(Qt::WA_OpaquePaintEvent);
+}
+
+void WaveformWidget::setWaveform(const Waveform &waveform)
+{
+    m_waveform = waveform;
+    m_view_begin = 0;
+    m_view_end = waveform.length();
+    m_position = 0;
+    m_loop_begin = m_loop_end = 0;
+    m_loop_anchor = -1;
+    update();
+}
+
+void WaveformWidget::clear()
+{
+    setWaveform(Waveform());
+}
+
+void WaveformWidget::setPosition(double position)
+{
+    if (columnAt(position) != columnAt(m_position)) {
+        m_position = position;
+        update();
+    }
+    m_position = position;
+}
+
+void WaveformWidget::loop(double *begin, double *end) const
+{
+    bool l_selected = m_loop_end > m_loop_begin;
+    *begin = l_selected ? m_loop_begin : 0;
+    *end = l_selected ? m_loop_end : m_waveform.length();
+}
+
+void WaveformWidget::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+    QPainter l_painter(this);
+    l_painter.fillRect(rect(), palette().base());
+    int l_middle = height() / 2;
+    l_painter.setPen(palette().mid().color());
+    l_painter.drawLine(0, l_middle, width(), l_middle);
+    if (m_waveform.isEmpty() || m_view_end <= m_view_begin)
+        return;
+
+    if (m_loop_end > m_loop_begin) {
+        QColor l_loop = palette().highlight().color();
+        l_loop.setAlpha(48);
+        int l_left = columnAt(m_loop_begin);
+        l_painter.fillRect(l_left, 0, columnAt(m_loop_end) - l_left + 1, height(), l_loop);
+    }
+
+    // Every column covers the same time, so one level fits all of them
+    double l_column = (m_view_end - m_view_begin) / width();
+    int l_level = m_waveform.levelFor(l_column);
+    double l_bucket = m_waveform.bucketLength(l_level);
+    double l_scale = (height() / 2 - 1) / 32767.0;
+
+    l_painter.setPen(palette().highlight().color());
+    for (int x = 0; x < width(); x++) {
+        double l_from = m_view_begin + x * l_column;
+        int l_first = int(l_from / l_bucket);
+        int l_last = qMax(l_first, int((l_from + l_column) / l_bucket) - 1);
+        if (l_first >= m_waveform.bucketCount(l_level))
+            break;
+
+        qint16 l_min, l_max;
+        m_waveform.peak(l_level, l_first, l_last, &l_min, &l_max);
+        l_painter.drawLine(x, l_middle - int(l_max * l_scale), x, l_middle - int(l_min * l_scale));
+    }
+
+    l_painter.setPen(palette().text().color());
+    int l_cursor = columnAt(m_position);
+    l_painter.drawLine(l_cursor, 0, l_cursor, height());
+}
+
+void WaveformWidget::wheelEvent(QWheelEvent *event)
+{
+    if (m_waveform.isEmpty()) {
+        event->ignore();
+        return;
+    }
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    double l_x = event->position().x();
+#else
+    double l_x = event->pos().x();
+#endif
+    // Zoom around the cursor, from the whole song down to a few buckets of level 0
+    double l_anchor = m_view_begin + (m_view_end - m_view_begin) * l_x / width();
+    double l_factor = std::pow(0.8, event->angleDelta().y() / 120.0);
+    double l_span = qBound(m_waveform.bucketLength(0) * 4, (m_view_end - m_view_begin) * l_factor, m_waveform.length());
+    m_view_begin = qBound(0.0, l_anchor - l_span * l_x / width(), m_waveform.length() - l_span);
+    m_view_end = m_view_begin + l_span;
+    update();
+    event->accept();
+}
+
+void WaveformWidget::mousePressEvent(QMouseEvent *event)
+{
+    if (m_waveform.isEmpty() || event->button() != Qt::LeftButton)
+        return;
+
+    double l_time = timeAt(event->pos().x());
+    if (event->modifiers() & Qt::ShiftModifier) {
+        m_loop_anchor = l_time;
+        m_loop_begin = m_loop_end = l_time;
+        update();
+        emit loopChanged(m_loop_begin, m_loop_end); // A click without dragging clears the loop
+        return;
+    }
+
+    m_loop_anchor = -1;
+    emit seekRequested(l_time);
+}
+
+void WaveformWidget::mouseMoveEvent(QMouseEvent *event)
+{
+    if (m_waveform.isEmpty() || !(event->buttons() & Qt::LeftButton))
+        return;
+
+    double l_time = timeAt(event->pos().x());
+    if (m_loop_anchor < 0) {
+        emit seekRequested(l_time);
+        return;
+    }
+
+    m_loop_begin = qMin(m_loop_anchor, l_time);
+    m_loop_end = qMax(m_loop_anchor, l_time);
+    update();
+    emit loopChanged(m_loop_begin, m_loop_end);
+}
+
+double WaveformWidget::timeAt(int x) const
+{
+    return qBound(0.0, m_view_begin + (m_view_end - m_view_begin) * x / width(), m_waveform.length());
+}
+
+int WaveformWidget::columnAt(double time) const
+{
+    if (m_view_end <= m_view_begin)
+        return 0;
+    return int((time - m_view_begin) / (m_view_end - m_view_begin) * width());
+}